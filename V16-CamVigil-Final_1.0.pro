@@ -26,17 +26,24 @@ SOURCES += \
     archivemanager.cpp \
     archivewidget.cpp \
     archiveworker.cpp \
+    async_logger.cpp \
     cameradetailswidget.cpp \
     cameramanager.cpp \
     camerastreams.cpp \
+    coverage_spans.cpp \
     db_reader.cpp \
     db_writer.cpp \
     fullscreenviewer.cpp \
+    gl_video_texture.cpp \
+    glcontainerwidget.cpp \
+    gst_bus_dispatcher.cpp \
     hik_osd.cpp \
     hik_time.cpp \
     layoutmanager.cpp \
     main.cpp \
     mainwindow.cpp \
+    metrics_registry.cpp \
+    metrics_server.cpp \
     navbar.cpp \
     operationstatuswidget.cpp \
     playback_controls.cpp \
@@ -53,9 +60,15 @@ SOURCES += \
     playback_video_box.cpp \
     playback_video_player_gst.cpp \
     playbackwindow.cpp \
+    retention_service.cpp \
+    rtsp_probe.cpp \
+    segment_file_pool.cpp \
+    segment_sink.cpp \
     settingswindow.cpp \
+    storage_ledger.cpp \
     storagedetailswidget.cpp \
     storageservice.cpp \
+    stream_supervisor.cpp \
     streammanager.cpp \
     streamworker.cpp \
     subscriptionmanager.cpp \
@@ -67,18 +80,26 @@ HEADERS += \
     archivemanager.h \
     archivewidget.h \
     archiveworker.h \
+    async_logger.h \
     cameradetailswidget.h \
     cameramanager.h \
     camerastreams.h \
     clickablelabel.h \
+    coverage_spans.h \
     db_reader.h \
     db_writer.h \
     fullscreenviewer.h \
+    gl_video_texture.h \
     glcontainerwidget.h \
+    gst_bus_dispatcher.h \
     hik_osd.h \
     hik_time.h \
+    keyframe_gate.h \
     layoutmanager.h \
+    live_frame.h \
     mainwindow.h \
+    metrics_registry.h \
+    metrics_server.h \
     navbar.h \
     operationstatuswidget.h \
     playback_controls.h \
@@ -95,9 +116,16 @@ HEADERS += \
     playback_video_box.h \
     playback_video_player_gst.h \
     playbackwindow.h \
+    retention_policy.h \
+    retention_service.h \
+    rtsp_probe.h \
+    segment_file_pool.h \
+    segment_sink.h \
     settingswindow.h \
+    storage_ledger.h \
     storagedetailswidget.h \
     storageservice.h \
+    stream_supervisor.h \
     streammanager.h \
     streamworker.h \
     subscriptionmanager.h \
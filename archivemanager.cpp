@@ -11,6 +11,8 @@
 #include <QtGlobal>
 
 #include "db_writer.h"
+#include "segment_file_pool.h"
+#include "streammanager.h"
 
 // Resolve storage root. Env override supported.
 QString ArchiveManager::defaultStorageRoot() {
@@ -19,22 +21,26 @@ QString ArchiveManager::defaultStorageRoot() {
     return QDir::homePath() + "/CamVigil_StoragePartition";
 }
 
+bool ArchiveManager::sharedIngestFromEnv() {
+    const QString v = qEnvironmentVariable("CAMVIGIL_SHARED_INGEST").trimmed().toLower();
+    const bool on = (v == "1" || v == "true" || v == "on");
+    return on && StreamManager::handoffFromEnv() == FrameHandoff::Sample;
+}
+
 ArchiveManager::ArchiveManager(QObject *parent)
     : QObject(parent),
       defaultDuration(300)  // 5 min
 {
     archiveDir = defaultStorageRoot() + "/CamVigilArchives";
     QDir().mkpath(archiveDir);
+    qRegisterMetaType<LiveFrame>("LiveFrame");
 
-    // Initial compute of dynamic watermarks
-    refreshRetentionWatermarks();
+    // Trigger purge after each finalized segment (debounced by the retention service)
+    connect(this, &ArchiveManager::segmentWritten, this, &ArchiveManager::cleanupArchive);
 
-    // Timer: refresh watermarks then purge check
-    connect(&cleanupTimer, &QTimer::timeout, this, [this]{
-        refreshRetentionWatermarks();
-        cleanupArchive();
-    });
-    cleanupTimer.start(5 * 60 * 1000);  // every 5 minutes
+    recSupervisor = new StreamSupervisor("record", this);
+    connect(recSupervisor, &StreamSupervisor::stateChanged, this, &ArchiveManager::recordingHealthChanged);
+    connect(recSupervisor, &StreamSupervisor::restartRequested, this, &ArchiveManager::restartWorker_);
 
     qDebug() << "[ArchiveManager] Initialized. archiveDir=" << archiveDir;
 }
@@ -42,7 +48,18 @@ ArchiveManager::ArchiveManager(QObject *parent)
 ArchiveManager::~ArchiveManager()
 {
     stopRecording();
-    if (dbThread) { dbThread->quit(); dbThread->wait(); dbThread = nullptr; }
+    if (retentionThread) {
+        retentionThread->requestInterruption();
+        retentionThread->quit();
+        retentionThread->wait();
+        retentionThread = nullptr;
+    }
+    if (dbThread) {
+        // Runs after every queued segment event, so the last batch is committed
+        QMetaObject::invokeMethod(db, "flushPending", Qt::BlockingQueuedConnection);
+        dbThread->quit(); dbThread->wait(); dbThread = nullptr;
+    }
+    delete segmentPool_;
     qDebug() << "[ArchiveManager] Destroyed.";
 }
 
@@ -61,6 +78,7 @@ void ArchiveManager::startRecording(const std::vector<CamHWProfile> &camProfiles
     if (!dbThread) {
         dbThread = new QThread(this);
         db = new DbWriter();
+        db->setLedger(&ledger_);
         db->moveToThread(dbThread);
         connect(dbThread, &QThread::finished, db, &QObject::deleteLater);
         dbThread->start();
@@ -75,6 +93,9 @@ void ArchiveManager::startRecording(const std::vector<CamHWProfile> &camProfiles
             Q_ARG(QString, QString::fromStdString(p.displayName)));
     }
 
+    if (!segmentPool_ && SegmentFilePool::enabledFromEnv())
+        segmentPool_ = new SegmentFilePool(archiveDir);
+
     sessionId = QUuid::createUuid().toString(QUuid::WithoutBraces);
     QMetaObject::invokeMethod(db, "beginSession", Qt::QueuedConnection,
         Q_ARG(QString, sessionId), Q_ARG(QString, archiveDir), Q_ARG(int, defaultDuration));
@@ -83,193 +104,171 @@ void ArchiveManager::startRecording(const std::vector<CamHWProfile> &camProfiles
     qDebug() << "[ArchiveManager] Master start:" << masterStart.toString("yyyyMMdd_HHmmss");
 
     for (size_t i = 0; i < camProfiles.size(); ++i) {
-        const auto &profile = camProfiles[i];
-        auto* worker = new ArchiveWorker(profile.url, static_cast<int>(i),
-                                         archiveDir, defaultDuration, masterStart);
-
-        connect(worker, &ArchiveWorker::recordingError, [](const std::string &err){
-            qDebug() << "[ArchiveManager] ArchiveWorker error:" << QString::fromStdString(err);
-        });
-
-        connect(worker, &ArchiveWorker::segmentOpened, this,
-            [this, camProfiles](int camIdx, const QString& path, qint64 startNs){
-                const QString camUrl = QString::fromStdString(camProfiles[camIdx].url);
-                QMetaObject::invokeMethod(db, "addSegmentOpened", Qt::QueuedConnection,
-                    Q_ARG(QString, sessionId), Q_ARG(QString, camUrl),
-                    Q_ARG(QString, path), Q_ARG(qint64, startNs));
-            });
-
-        connect(worker, &ArchiveWorker::segmentClosed, this,
-            [this](int camIdx, const QString& path, qint64 endNs, qint64 durMs){
-                Q_UNUSED(camIdx);
-                QMetaObject::invokeMethod(db, "finalizeSegmentByPath", Qt::QueuedConnection,
-                    Q_ARG(QString, path), Q_ARG(qint64, endNs), Q_ARG(qint64, durMs));
-            });
-
-        // Trigger purge after each finalized segment
-        connect(worker, &ArchiveWorker::segmentFinalized, this, &ArchiveManager::segmentWritten);
-        connect(this, &ArchiveManager::segmentWritten, this, &ArchiveManager::cleanupArchive);
-
-        workers.push_back(worker);
-        worker->start();
+        workers.push_back(spawnWorker_(static_cast<int>(i), masterStart));
         qDebug() << "[ArchiveManager] Started ArchiveWorker for cam" << i;
     }
 
     qDebug() << "[ArchiveManager] Recording at" << archiveDir;
 
-    // Kick an immediate check at startup
-    QTimer::singleShot(0, this, [this]{ refreshRetentionWatermarks(); cleanupArchive(); });
+    // Retention starts with an immediate check
+    if (retention) refreshRetentionPolicies(cameraProfiles);
+    startRetention_();
 }
 
-// -----------------------------------------------
-
-void ArchiveManager::stopRecording()
+void ArchiveManager::startRetention_()
 {
-    for (auto* worker : workers) { worker->stop(); worker->wait(); delete worker; }
-    workers.clear();
-    qDebug() << "[ArchiveManager] All ArchiveWorkers stopped.";
+    if (retentionThread || !db) return;
+    retentionThread = new QThread(this);
+    retentionThread->setObjectName("retention");
+    retention = new RetentionService(archiveDir, db, segmentPool_, &ledger_);
+    retention->moveToThread(retentionThread);
+    connect(retentionThread, &QThread::finished, retention, &QObject::deleteLater);
+    connect(retention, &RetentionService::purgeProgress, this, &ArchiveManager::purgeProgress);
+    connect(retention, &RetentionService::purgeFinished, this, &ArchiveManager::purgeFinished);
+    retentionThread->start();
+    refreshRetentionPolicies(cameraProfiles);
+    QMetaObject::invokeMethod(retention, "start", Qt::QueuedConnection);
 }
 
-void ArchiveManager::updateSegmentDuration(int seconds)
+void ArchiveManager::refreshRetentionPolicies(const std::vector<CamHWProfile>& profiles)
 {
-    qDebug() << "[ArchiveManager] Update segment duration to" << seconds << "s";
-    for (auto *worker : workers)
-        QMetaObject::invokeMethod(worker, "updateSegmentDuration", Qt::QueuedConnection,
-                                  Q_ARG(int, seconds));
+    if (!retention) return;
+    QHash<QString, RetentionPolicy> policies;
+    for (const auto& p : profiles)
+        if (!p.retention.isDefault()) policies.insert(QString::fromStdString(p.url), p.retention);
+    RetentionService* r = retention;
+    QMetaObject::invokeMethod(r, [r, policies]{ r->setPolicies(policies); }, Qt::QueuedConnection);
 }
 
-// ---------- Dynamic watermarks ----------
-
-static double envPct(const char* name, double fallbackPct)
+ArchiveWorker* ArchiveManager::spawnWorker_(int camIndex, const QDateTime& masterStart)
 {
-    bool ok=false;
-    const QString s = qEnvironmentVariable(name);
-    if (!s.isEmpty()) {
-        const double v = s.toDouble(&ok);
-        if (ok) return qBound(0.0, v/100.0, 0.95); // 72 -> 0.72
+    const auto &profile = cameraProfiles[camIndex];
+    auto* worker = new ArchiveWorker(profile.url, camIndex,
+                                     archiveDir, defaultDuration, masterStart);
+    const bool shared = sharedIngestFromEnv();
+    worker->setSharedIngest(shared);
+    worker->setSegmentPool(segmentPool_);
+    worker->setLiveVisible(!hiddenLive_.contains(camIndex));
+    if (shared) {
+        connect(worker, &ArchiveWorker::liveFrameReady, this, &ArchiveManager::liveFrameReady);
+        connect(worker, &ArchiveWorker::fullFrameReady, this, &ArchiveManager::fullFrameReady);
     }
-    return qBound(0.0, fallbackPct/100.0, 0.95);    // << divide fallback too
-}
 
+    connect(worker, &ArchiveWorker::recordingError, this, [this, camIndex](const std::string &err){
+        qWarning() << "[ArchiveManager] ArchiveWorker error:" << QString::fromStdString(err);
+        if (!stopping_) recSupervisor->markFailed(camIndex, QString::fromStdString(err));
+    });
+    // run() returned without stopRecording(): pipeline failed to start or died
+    connect(worker, &QThread::finished, this, [this, worker, camIndex]{
+        if (stopping_ || camIndex >= static_cast<int>(workers.size()) || workers[camIndex] != worker) return;
+        recSupervisor->markFailed(camIndex, "pipeline stopped");
+    });
 
-void ArchiveManager::refreshRetentionWatermarks()
-{
-    QStorageInfo si(archiveDir);
-    if (!si.isValid() || si.bytesTotal() <= 0) return;
+    connect(worker, &ArchiveWorker::segmentOpened, this,
+        [this](int camIdx, const QString& path, qint64 startNs){
+            recSupervisor->markLive(camIdx);
+            const QString camUrl = QString::fromStdString(cameraProfiles[camIdx].url);
+            QMetaObject::invokeMethod(db, "addSegmentOpened", Qt::QueuedConnection,
+                Q_ARG(QString, sessionId), Q_ARG(QString, camUrl),
+                Q_ARG(QString, path), Q_ARG(qint64, startNs));
+        });
 
-    const qint64 total = si.bytesTotal();
+    connect(worker, &ArchiveWorker::segmentClosed, this,
+        [this](int camIdx, const QString& path, qint64 endNs, qint64 durMs){
+            Q_UNUSED(camIdx);
+            // A recycled file keeps its previous length until the sink cuts it at EOS,
+            // and finalize reads the size: wait for fragment-closed.
+            if (segmentPool_ && !closedFiles_.remove(path)) {
+                pendingFinalize_.insert(path, qMakePair(endNs, durMs));
+                return;
+            }
+            QMetaObject::invokeMethod(db, "finalizeSegmentByPath", Qt::QueuedConnection,
+                Q_ARG(QString, path), Q_ARG(qint64, endNs), Q_ARG(qint64, durMs));
+        });
 
-    // Defaults: start at 10% free, recover to 12% free. Overridable via env.
-    const double minPct    = envPct("CAMVIGIL_MIN_FREE_PCT",    70.0);
-    const double targetPct = envPct("CAMVIGIL_TARGET_FREE_PCT", 72.0);
+    connect(worker, &ArchiveWorker::segmentFileClosed, this,
+        [this](int camIdx, const QString& path){
+            Q_UNUSED(camIdx);
+            if (!segmentPool_) return;
+            auto it = pendingFinalize_.find(path);
+            if (it == pendingFinalize_.end()) { closedFiles_.insert(path); return; }   // EOS: closed first
+            QMetaObject::invokeMethod(db, "finalizeSegmentByPath", Qt::QueuedConnection,
+                Q_ARG(QString, path), Q_ARG(qint64, it->first), Q_ARG(qint64, it->second));
+            pendingFinalize_.erase(it);
+        });
 
-    rcfg_.minFreeBytes    = static_cast<qint64>(total * minPct);
-    rcfg_.targetFreeBytes = static_cast<qint64>(total * targetPct);
-    rcfg_.highWaterPct    = 90; // 90% used is an alternate trigger
+    connect(worker, &ArchiveWorker::segmentFinalized, this, &ArchiveManager::segmentWritten);
 
-    qInfo() << "[Purge] watermarks set:"
-            << "total=" << total
-            << "minFreeBytes=" << rcfg_.minFreeBytes
-            << "targetFreeBytes=" << rcfg_.targetFreeBytes
-            << "highWater%=" << rcfg_.highWaterPct;
+    recSupervisor->markConnecting(camIndex);
+    worker->start();
+    return worker;
 }
 
-// ---------- Ring-buffer helpers ----------
-
-bool ArchiveManager::shouldPurge_(qint64& needBytes, qint64& availBytes) {
-    QStorageInfo si(archiveDir);
-    if (!si.isValid()) return false;
-    const qint64 total = si.bytesTotal();
-    availBytes = si.bytesAvailable();
-    if (total <= 0) return false;
-    const int usedPct = int((total - availBytes) * 100 / total);
-
-    const bool trigger = (availBytes < rcfg_.minFreeBytes) || (usedPct >= rcfg_.highWaterPct);
-    qInfo() << "[Purge] check avail=" << availBytes
-            << "total=" << total
-            << "used%=" << usedPct
-            << "minFree=" << rcfg_.minFreeBytes
-            << "targetFree=" << rcfg_.targetFreeBytes
-            << "trigger=" << trigger;
-
-    if (trigger) {
-        needBytes = qMax<qint64>(rcfg_.targetFreeBytes - availBytes, 0);
-        return needBytes > 0;
+// Supervisor backoff expired: replace the dead recorder with a fresh one.
+void ArchiveManager::restartWorker_(int camIndex)
+{
+    if (stopping_ || camIndex < 0 || camIndex >= static_cast<int>(workers.size())) return;
+    ArchiveWorker* old = workers[camIndex];
+    if (old && old->isRunning()) {
+        // Still draining EOS after the error (the bus handler already stopped it);
+        // respawn once its thread has finished.
+        if (restartPending_.contains(camIndex)) return;
+        restartPending_.insert(camIndex);
+        connect(old, &QThread::finished, this, [this, camIndex, old]{
+            if (!restartPending_.remove(camIndex) || stopping_) return;
+            if (camIndex >= static_cast<int>(workers.size()) || workers[camIndex] != old) return;
+            old->wait();   // finished is emitted just before run() returns
+            restartWorker_(camIndex);
+        });
+        return;
     }
-    return false;
-}
+    if (old) old->deleteLater();
 
-bool ArchiveManager::purgeOnce_(qint64& freedBytes) {
-    freedBytes = 0;
-    QVector<QPair<qint64, QString>> victims;
-    const bool okFetch = QMetaObject::invokeMethod(
-        db, [&]{ victims = db->oldestFinalizedUnpinned(rcfg_.purgeBatchFiles, 0, rcfg_.perCameraMinDays); },
-        Qt::BlockingQueuedConnection);
-    if (!okFetch || victims.isEmpty()) return false;
-
-    qInfo() << "[Purge] batch candidates=" << victims.size()
-            << "batch_limit=" << rcfg_.purgeBatchFiles;
-
-    for (const auto& v : victims) {
-        const qint64 id = v.first;
-        const QString path = v.second;
-
-        QFile f(path);
-        const qint64 sz = f.exists() ? f.size() : 0;
-
-        bool ok = !f.exists() || f.remove();
-        if (!ok) { QThread::msleep(50); ok = !f.exists() || f.remove(); }
-        if (!ok) { qWarning() << "[Purge] unlink failed:" << path; continue; }
-
-        bool rowOk = false;
-        QMetaObject::invokeMethod(db, [&]{ rowOk = db->deleteSegmentRow(id); },
-                                  Qt::BlockingQueuedConnection);
-        if (!rowOk) { qWarning() << "[Purge] DB row delete failed id=" << id; continue; }
-
-        freedBytes += sz;
-
-        QStorageInfo si(archiveDir);
-        if (si.isValid()) {
-            const qint64 freeNow = si.bytesAvailable();
-            qInfo() << "[Purge] deleted" << path << "size=" << sz
-                    << "free_now=" << freeNow;
-            if (freeNow >= rcfg_.targetFreeBytes) break;
-        }
-    }
-    return true;
+    // New timeline: restarted PTS begin at zero, so anchor file names to now.
+    qDebug() << "[ArchiveManager] Restarting ArchiveWorker for cam" << camIndex;
+    workers[camIndex] = spawnWorker_(camIndex, QDateTime::currentDateTime());
 }
 
-// ---------- Purge entry point ----------
+// -----------------------------------------------
 
-void ArchiveManager::cleanupArchive()
+void ArchiveManager::stopRecording()
 {
-    if (archiveDir.isEmpty()) return;
-    if (!QDir(archiveDir).exists()) return;
-    if (purgeRunning_.fetchAndStoreOrdered(1) == 1) return;
+    stopping_ = true;
+    recSupervisor->clear();
+    restartPending_.clear();
+    for (auto* worker : workers) { worker->stop(); worker->wait(); delete worker; }
+    workers.clear();
+    stopping_ = false;
+    qDebug() << "[ArchiveManager] All ArchiveWorkers stopped.";
+}
 
-    qint64 need=0, avail=0;
-    if (!shouldPurge_(need, avail)) {
-        purgeRunning_.storeRelease(0);
-        return;
-    }
+void ArchiveManager::setFullResolution(int camIndex, bool on)
+{
+    if (camIndex < 0 || camIndex >= static_cast<int>(workers.size())) return;
+    workers[camIndex]->setFullResolution(on);
+}
 
-    qint64 totalFreed = 0;
-    while (true) {
-        qint64 freed = 0;
-        const bool any = purgeOnce_(freed);
-        totalFreed += freed;
+void ArchiveManager::setLiveVisible(int camIndex, bool visible)
+{
+    if (visible) hiddenLive_.remove(camIndex);
+    else hiddenLive_.insert(camIndex);
+    if (camIndex < 0 || camIndex >= static_cast<int>(workers.size())) return;
+    workers[camIndex]->setLiveVisible(visible);
+}
 
-        QStorageInfo si(archiveDir);
-        const bool done = !si.isValid()
-                       || si.bytesAvailable() >= rcfg_.targetFreeBytes
-                       || !any;
-        if (done) break;
+void ArchiveManager::updateSegmentDuration(int seconds)
+{
+    qDebug() << "[ArchiveManager] Update segment duration to" << seconds << "s";
+    defaultDuration = seconds;   // restarted recorders pick it up
+    for (auto *worker : workers)
+        QMetaObject::invokeMethod(worker, "updateSegmentDuration", Qt::QueuedConnection,
+                                  Q_ARG(int, seconds));
+}
 
-        QThread::msleep(20);
-    }
+// ---------- Purge entry point ----------
 
-    QStorageInfo si2(archiveDir);
-    qInfo() << "[Purge] exit freed_total=" << totalFreed
-            << "free_now=" << (si2.isValid() ? si2.bytesAvailable() : -1);
-    purgeRunning_.storeRelease(0);
+void ArchiveManager::cleanupArchive()
+{
+    if (!retention) return;
+    QMetaObject::invokeMethod(retention, "requestPurge", Qt::QueuedConnection);
 }
@@ -4,27 +4,20 @@
 #include <QObject>
 #include <QTimer>
 #include <QThread>
-#include <QAtomicInt>
+#include <QSet>
+#include <QHash>
+#include <QPair>
 #include <vector>
 #include <string>
 
 #include "archiveworker.h"
 #include "camerastreams.h" // CamHWProfile
+#include "stream_supervisor.h"
+#include "retention_service.h"
+#include "storage_ledger.h"
 
 class DbWriter;
-
-// Dynamic, size-based ring buffer config.
-// minFreeBytes/targetFreeBytes are computed from total capacity by refreshRetentionWatermarks().
-// Override percentages via env:
-//   CAMVIGIL_MIN_FREE_PCT    (default 10)
-//   CAMVIGIL_TARGET_FREE_PCT (default 12)
-struct RetentionCfg {
-    qint64 minFreeBytes     = 0;   // computed each refresh
-    qint64 targetFreeBytes  = 0;   // computed each refresh
-    int    highWaterPct     = 90;  // purge if used% >= this
-    int    purgeBatchFiles  = 64;  // delete in batches
-    int    perCameraMinDays = 0;   // keep N days per camera (0=off)
-};
+class SegmentFilePool;
 
 class ArchiveManager : public QObject {
     Q_OBJECT
@@ -37,23 +30,46 @@ public:
 
     void startRecording(const std::vector<CamHWProfile>& cameraProfiles);
     void stopRecording();
+    // Re-reads per-camera retention policies (cameras.json may have changed).
+    void refreshRetentionPolicies(const std::vector<CamHWProfile>& profiles);
     void updateSegmentDuration(int seconds);
 
     static QString defaultStorageRoot();
 
+    // Byte accounting for the archive (used/free/per camera/per day); valid after
+    // the retention thread's first reconcile.
+    const StorageLedger& storageLedger() const { return ledger_; }
+
+    // CAMVIGIL_SHARED_INGEST=1: one RTSP session per camera feeds recorder and live wall.
+    // Only honoured with the GL grid (sample handoff); the QLabel wall keeps its own sessions.
+    static bool sharedIngestFromEnv();
+
+    // Recorder pipeline health per camera; failed recorders restart with backoff.
+    StreamHealth recordingHealth(int camIndex) const { return recSupervisor->state(camIndex); }
+
 public slots:
-    void cleanupArchive(); // ring-buffer purge
+    void cleanupArchive(); // ring-buffer purge (queued to the retention thread)
+    void setFullResolution(int camIndex, bool on); // shared ingest: fullscreen branch
+    void setLiveVisible(int camIndex, bool visible); // shared ingest: keyframe-only when hidden
 
 signals:
     void segmentWritten(); // emitted after a segment finalizes
+    void liveFrameReady(int camIndex, const LiveFrame& frame);
+    void fullFrameReady(int camIndex, const LiveFrame& frame);
+    void recordingHealthChanged(int camIndex, StreamHealth state);
+    void purgeProgress(qint64 freedBytes, int filesRemoved);
+    void purgeFinished(qint64 freedBytes, int filesRemoved);
 
 private:
-    // timers/workers
-    QTimer cleanupTimer;
+    // workers
     std::vector<ArchiveWorker*> workers;
     QString archiveDir;
     int defaultDuration;  // seconds
     std::vector<CamHWProfile> cameraProfiles;
+    StreamSupervisor* recSupervisor = nullptr;
+    bool stopping_ = false;
+    QSet<int> hiddenLive_;             // shared ingest tiles hidden by the UI
+    QSet<int> restartPending_;         // waiting for a draining recorder's thread to finish
 
     // DB
     QThread*  dbThread = nullptr;
@@ -61,13 +77,17 @@ private:
     QString   sessionId;
 
     // retention
-    RetentionCfg rcfg_;
-    QAtomicInt   purgeRunning_{0}; // 0=idle,1=running
+    QThread*          retentionThread = nullptr;
+    RetentionService* retention       = nullptr;
+    SegmentFilePool*  segmentPool_    = nullptr; // CAMVIGIL_RECYCLE_SEGMENTS; null when off
+    QHash<QString, QPair<qint64, qint64>> pendingFinalize_;   // recycling: path -> (endNs, durMs)
+    QSet<QString>     closedFiles_;                           // recycling: closed before segmentClosed
+    StorageLedger     ledger_;
 
     // helpers
-    void refreshRetentionWatermarks();     // compute bytes from % of total
-    bool shouldPurge_(qint64& needBytes, qint64& availBytes);
-    bool purgeOnce_(qint64& freedBytes);
+    ArchiveWorker* spawnWorker_(int camIndex, const QDateTime& masterStart);
+    void restartWorker_(int camIndex);
+    void startRetention_();
 };
 
 #endif // ARCHIVEMANAGER_H
@@ -2,8 +2,18 @@
 #include <QDir>
 #include <QDebug>
 #include <QThread>
+#include <QThreadPool>
 #include <QMutexLocker>
 #include <gst/gst.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include "gst_bus_dispatcher.h"
+#include "metrics_registry.h"
+#include "segment_file_pool.h"
+#include "segment_sink.h"
+#include "streamworker.h"
 
 ArchiveWorker::ArchiveWorker(const std::string& url,
                              int camIndex,
@@ -20,6 +30,20 @@ ArchiveWorker::ArchiveWorker(const std::string& url,
       masterStart(mStart),
       pipeline(nullptr)
 {
+    const QString prealloc = qEnvironmentVariable("CAMVIGIL_PREALLOC_SEGMENTS").trimmed().toLower();
+    preallocSegments = (prealloc == "1" || prealloc == "true" || prealloc == "on");
+    bool ok = false;
+    const int kbps = qEnvironmentVariable("CAMVIGIL_RECORD_BITRATE_KBPS").toInt(&ok);
+    recordBitrateBps = qint64(ok && kbps > 0 ? kbps : 4096) * 1000;
+    const int bufKb = qEnvironmentVariable("CAMVIGIL_RECORD_WRITE_BUFFER_KB").toInt(&ok);
+    writeBufferBytes = (ok ? qMax(0, bufKb) : 0) * 1024;   // off unless asked for: buffered bytes die with a crash
+    writeBufferBytes -= writeBufferBytes % 4096;
+
+    auto& m = MetricsRegistry::instance();
+    const QString cam = MetricsRegistry::label("camera", cameraIndex);
+    mSegmentOpen  = &m.histogram("camvigil_segment_open_seconds", "Time spent choosing and opening the next segment file", cam);
+    mSegmentClose = &m.histogram("camvigil_segment_close_seconds", "Rollover to fragment-closed latency per segment", cam);
+
     qDebug() << "[ArchiveWorker] Created for cam" << cameraIndex
              << "with masterStart:" << masterStart.toString("yyyyMMdd_HHmmss");
 }
@@ -45,6 +69,9 @@ void ArchiveWorker::createPipeline() {
         return;
     }
 
+    // Recycled files are overwritten in place; filesink would truncate them on open.
+    const bool recycling = segmentPool && SegmentSink::registerElement();
+
     // 2) Configure elements
     g_object_set(src,
                  "location", cameraUrl.c_str(),
@@ -57,20 +84,33 @@ void ArchiveWorker::createPipeline() {
                  "max-size-time",     maxSizeTimeNs,
                  "async-finalize",    TRUE,
                  "muxer-factory",    "matroskamux",
+                 "sink-factory",     recycling ? SegmentSink::kFactoryName : "filesink",
                  nullptr);
 
+    // Per-fragment filesink tuning / preallocation (async-finalize creates one sink per fragment)
+    if (preallocSegments || writeBufferBytes > 0) {
+        g_signal_connect(split, "sink-added", G_CALLBACK(ArchiveWorker::onSinkAdded), this);
+    }
+
     // 3) Add to pipeline
     gst_bin_add_many(GST_BIN(pipeline), src, depay, parse, split, nullptr);
 
     // 4) Link static pads
     if (!gst_element_link(depay, parse) ||
-        !gst_element_link(parse, split)) {
+        !(sharedIngest ? linkSharedIngest(parse, split) : gst_element_link(parse, split))) {
         emit recordingError("Failed to link depay → parse → splitmuxsink");
         gst_object_unref(pipeline);
         pipeline = nullptr;
         return;
     }
 
+    // Ingest counters: compressed stream after parse, losses from the jitterbuffers
+    if (GstPad* parseSrc = gst_element_get_static_pad(parse, "src")) {
+        gst_pad_add_probe(parseSrc, GST_PAD_PROBE_TYPE_BUFFER, &ArchiveWorker::onIngestBuffer, this, nullptr);
+        gst_object_unref(parseSrc);
+    }
+    g_signal_connect(src, "new-manager", G_CALLBACK(ArchiveWorker::onNewManager), this);
+
     // 5) Handle dynamic pad from rtspsrc → depay
     g_signal_connect(src, "pad-added",
                      G_CALLBACK(+[](GstElement* src, GstPad* pad, gpointer user_data){
@@ -82,12 +122,10 @@ void ArchiveWorker::createPipeline() {
         gst_object_unref(sinkpad);
     }), depay);
 
-    // 6) Bus watch
-    GstBus* bus = gst_element_get_bus(pipeline);
-    gst_bus_add_signal_watch(bus);
-    g_signal_connect(bus, "message",
-                     G_CALLBACK(ArchiveWorker::onBusMessage), this);
-    gst_object_unref(bus);
+    // 6) Bus watch (shared dispatcher thread)
+    busWatch = GstBusDispatcher::instance().watch(pipeline, [this](GstMessage* msg){
+        onBusMessage(msg);
+    });
 
     // 7) Connect the format-location-full signal on our splitmuxsink
     g_signal_connect(split,
@@ -103,18 +141,185 @@ void ArchiveWorker::createPipeline() {
 
 
 
+bool ArchiveWorker::linkSharedIngest(GstElement* parse, GstElement* split) {
+    GstElement* tee  = gst_element_factory_make("tee",   "ingest");
+    GstElement* recq = gst_element_factory_make("queue", "recq");
+    if (!tee || !recq) return false;
+
+    // Recorder branch: bounded by time only, never leaky.
+    g_object_set(recq,
+                 "max-size-buffers", 0,
+                 "max-size-bytes",   0,
+                 "max-size-time",    static_cast<guint64>(3 * GST_SECOND),
+                 nullptr);
+    gst_bin_add_many(GST_BIN(pipeline), tee, recq, nullptr);
+    if (!gst_element_link(parse, tee) || !gst_element_link_many(tee, recq, split, nullptr))
+        return false;
+
+    // Live branches share one decoder. Its input queue is leaky so a slow decoder
+    // can never back-pressure the tee and starve the recorder.
+    const QString decoder = StreamWorker::liveDecoderName();
+    const bool vaapi = (decoder == "vaapih264dec");
+    const QString desc = QString(
+        "queue leaky=downstream max-size-buffers=0 max-size-bytes=0 max-size-time=2000000000 ! "
+        "%1 ! tee name=dec "
+        "dec. ! queue leaky=downstream max-size-buffers=2 ! %2 ! "
+        "video/x-raw,format=(string){NV12,I420},width=640,height=480 ! "
+        "appsink name=live sync=false drop=true max-buffers=1 "
+        "dec. ! valve name=fullvalve drop=true ! queue leaky=downstream max-size-buffers=2 ! %3"
+        "video/x-raw,format=(string){NV12,I420} ! "
+        "appsink name=full sync=false drop=true max-buffers=1")
+        .arg(decoder,
+             vaapi ? "vaapipostproc" : "videoscale",
+             vaapi ? "vaapipostproc ! " : "");
+
+    GError* error = nullptr;
+    GstElement* live = gst_parse_bin_from_description(desc.toUtf8().constData(), TRUE, &error);
+    if (!live) {
+        qWarning() << "[ArchiveWorker] Live branch failed for cam" << cameraIndex << ":"
+                   << (error ? error->message : "unknown");
+        if (error) g_error_free(error);
+        return false;
+    }
+    gst_bin_add(GST_BIN(pipeline), live);
+    if (!gst_element_link(tee, live)) return false;
+
+    // Gate compressed input of the live decoder only; recq still sees every buffer.
+    if (GstPad* livePad = gst_element_get_static_pad(live, "sink")) {
+        liveGate.attach(livePad);
+        gst_object_unref(livePad);
+    }
+
+    GstAppSinkCallbacks liveCb = {};
+    liveCb.new_sample = &ArchiveWorker::onLiveSample;
+    GstAppSinkCallbacks fullCb = {};
+    fullCb.new_sample = &ArchiveWorker::onFullSample;
+
+    GstElement* liveSink = gst_bin_get_by_name(GST_BIN(live), "live");
+    GstElement* fullSink = gst_bin_get_by_name(GST_BIN(live), "full");
+    if (liveSink) {
+        gst_app_sink_set_callbacks(GST_APP_SINK(liveSink), &liveCb, this, nullptr);
+        gst_object_unref(liveSink);
+    }
+    if (fullSink) {
+        gst_app_sink_set_callbacks(GST_APP_SINK(fullSink), &fullCb, this, nullptr);
+        gst_object_unref(fullSink);
+    }
+
+    const double fps = StreamWorker::targetFpsFromEnv();
+    liveMinIntervalUs = fps > 0.0 ? static_cast<qint64>(1000000.0 / fps) : 0;
+    {
+        QMutexLocker lk(&curMutex);
+        fullValve = gst_bin_get_by_name(GST_BIN(live), "fullvalve");
+    }
+    qDebug() << "[ArchiveWorker] Shared ingest (recorder + live" << decoder << ") for cam" << cameraIndex;
+    return true;
+}
+
+GstFlowReturn ArchiveWorker::onLiveSample(GstAppSink* sink, gpointer user_data) {
+    auto* worker = static_cast<ArchiveWorker*>(user_data);
+    GstSample* sample = gst_app_sink_pull_sample(sink);
+    if (!sample) return GST_FLOW_OK;
+
+    const qint64 now = g_get_monotonic_time();
+    const qint64 interval = worker->liveMinIntervalUs.load();
+    if (interval > 0 && now - worker->liveLastEmitUs.load() < interval) {
+        gst_sample_unref(sample);
+        return GST_FLOW_OK;
+    }
+    worker->liveLastEmitUs = now;
+    emit worker->liveFrameReady(worker->cameraIndex, LiveFrame(sample));
+    return GST_FLOW_OK;
+}
+
+GstFlowReturn ArchiveWorker::onFullSample(GstAppSink* sink, gpointer user_data) {
+    auto* worker = static_cast<ArchiveWorker*>(user_data);
+    GstSample* sample = gst_app_sink_pull_sample(sink);
+    if (sample) emit worker->fullFrameReady(worker->cameraIndex, LiveFrame(sample));
+    return GST_FLOW_OK;
+}
+
+void ArchiveWorker::setFullResolution(bool on) {
+    QMutexLocker lk(&curMutex);
+    if (!fullValve) return;
+    g_object_set(fullValve, "drop", on ? FALSE : TRUE, nullptr);
+    qDebug() << "[ArchiveWorker] Full-res branch" << (on ? "opened" : "closed") << "for cam" << cameraIndex;
+}
+
 void ArchiveWorker::cleanupPipeline() {
-    if (pipeline) {
-        gst_element_set_state(pipeline, GST_STATE_NULL);
-        gst_object_unref(pipeline);
+    GstBusDispatcher::instance().unwatch(busWatch);
+    busWatch = 0;
+    {
+        QMutexLocker lk(&statsMutex);
+        for (GstElement* jb : jitterBuffers) gst_object_unref(jb);
+        jitterBuffers.clear();
+        closeRequestedUs.clear();   // fragments that never reported fragment-closed
+    }
+    {
+        QMutexLocker lk(&curMutex);
+        if (fullValve) {
+            gst_object_unref(fullValve);
+            fullValve = nullptr;
+        }
+    }
+    GstElement* p = nullptr;
+    {
+        // stop() may still be called from the bus or GUI thread
+        QMutexLocker lk(&runMutex);
+        p = pipeline;
         pipeline = nullptr;
     }
+    if (p) {
+        gst_element_set_state(p, GST_STATE_NULL);
+        gst_object_unref(p);
+    }
+}
+
+GstPadProbeReturn ArchiveWorker::onIngestBuffer(GstPad* pad, GstPadProbeInfo* info, gpointer user_data) {
+    Q_UNUSED(pad);
+    auto* worker = static_cast<ArchiveWorker*>(user_data);
+    GstBuffer* buf = GST_PAD_PROBE_INFO_BUFFER(info);
+    worker->ingestBytes.fetch_add(gst_buffer_get_size(buf), std::memory_order_relaxed);
+    worker->ingestBuffers.fetch_add(1, std::memory_order_relaxed);
+    return GST_PAD_PROBE_OK;
+}
+
+void ArchiveWorker::onNewManager(GstElement* src, GstElement* manager, gpointer user_data) {
+    Q_UNUSED(src);
+    g_signal_connect(manager, "new-jitterbuffer", G_CALLBACK(ArchiveWorker::onNewJitterBuffer), user_data);
+}
+
+void ArchiveWorker::onNewJitterBuffer(GstElement* rtpbin, GstElement* jb, guint session, guint ssrc, gpointer user_data) {
+    Q_UNUSED(rtpbin); Q_UNUSED(session); Q_UNUSED(ssrc);
+    auto* worker = static_cast<ArchiveWorker*>(user_data);
+    QMutexLocker lk(&worker->statsMutex);
+    worker->jitterBuffers.push_back(GST_ELEMENT(gst_object_ref(jb)));
+}
+
+ArchiveWorker::IngestStats ArchiveWorker::ingestStats() const {
+    IngestStats st;
+    st.bytes   = ingestBytes.load(std::memory_order_relaxed);
+    st.buffers = ingestBuffers.load(std::memory_order_relaxed);
+    QMutexLocker lk(&statsMutex);
+    for (GstElement* jb : jitterBuffers) {
+        GstStructure* s = nullptr;
+        g_object_get(jb, "stats", &s, nullptr);
+        guint64 lost = 0;
+        if (s && gst_structure_get_uint64(s, "num-lost", &lost)) st.packetsLost += lost;
+        if (s) gst_structure_free(s);
+    }
+    return st;
 }
 
 void ArchiveWorker::run() {
+    {
+        // A previous run's EOS must not let the next stop() skip the drain.
+        QMutexLocker lk(&runMutex);
+        eosReceived = false;
+    }
     createPipeline();
     if (!pipeline) {
-        qDebug() << "[ArchiveWorker] Pipeline creation failed for cam" << cameraIndex << ". Exiting.";
+        qWarning() << "[ArchiveWorker] Pipeline creation failed for cam" << cameraIndex << ". Exiting.";
         return;
     }
 
@@ -129,21 +334,28 @@ void ArchiveWorker::run() {
     qDebug() << "[ArchiveWorker] Pipeline running for cam" << cameraIndex;
     running.store(true);
 
-    GMainLoop *loop = g_main_loop_new(nullptr, FALSE);
-    while (running.load()) {
-        if (!g_main_context_iteration(g_main_loop_get_context(loop), FALSE)) {
-            QThread::msleep(100); // Fallback if no events
+    {
+        QMutexLocker lk(&runMutex);
+        while (running.load()) {
+            runCondition.wait(&runMutex);
+        }
+        // stop() sent EOS; let splitmuxsink finalize the open fragment first
+        if (!eosReceived) {
+            runCondition.wait(&runMutex, kEosDrainMs);
         }
     }
-    g_main_loop_unref(loop);
     cleanupPipeline();
     qDebug() << "[ArchiveWorker] Pipeline stopped for cam" << cameraIndex;
 }
 
 void ArchiveWorker::stop() {
     running.store(false);
-    if (pipeline) {
-        gst_element_send_event(pipeline, gst_event_new_eos()); // Ensures the  final segment is written
+    {
+        QMutexLocker lk(&runMutex);
+        if (pipeline) {
+            gst_element_send_event(pipeline, gst_event_new_eos()); // Ensures the  final segment is written
+        }
+        runCondition.wakeAll();
     }
     qDebug() << "[ArchiveWorker] Stop called for cam" << cameraIndex;
 }
@@ -159,15 +371,78 @@ void ArchiveWorker::updateSegmentDuration(int seconds) {
             g_signal_emit_by_name(sink, "split-now", NULL);
             gst_object_unref(sink);
         } else {
-            qDebug() << "[ArchiveWorker] Failed to get splitmuxsink for split-now on cam" << cameraIndex;
+            qWarning() << "[ArchiveWorker] Failed to get splitmuxsink for split-now on cam" << cameraIndex;
+        }
+    }
+}
+
+void ArchiveWorker::onSinkAdded(GstElement* splitmux, GstElement* sink, gpointer user_data) {
+    Q_UNUSED(splitmux);
+    auto* worker = static_cast<ArchiveWorker*>(user_data);
+    if (worker->writeBufferBytes > 0 &&
+        g_object_class_find_property(G_OBJECT_GET_CLASS(sink), "buffer-mode")) {
+        // Full buffering batches the muxer's small appends into buffer-size writes; header
+        // rewrites after a seek flush early, so batches are not guaranteed page-aligned.
+        g_object_set(sink,
+                     "buffer-mode", 0,                 // GST_FILE_SINK_BUFFER_MODE_FULL
+                     "buffer-size", guint(worker->writeBufferBytes),
+                     nullptr);
+    }
+    if (worker->preallocSegments) {
+        // filesink opens (and truncates) the file on start, so allocate on the first buffer.
+        GstPad* pad = gst_element_get_static_pad(sink, "sink");
+        if (pad) {
+            gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_BUFFER,
+                              &ArchiveWorker::onFirstSegmentBuffer, worker, nullptr);
+            gst_object_unref(pad);
         }
     }
 }
 
+GstPadProbeReturn ArchiveWorker::onFirstSegmentBuffer(GstPad* pad, GstPadProbeInfo* info, gpointer user_data) {
+    Q_UNUSED(info);
+    auto* worker = static_cast<ArchiveWorker*>(user_data);
+    GstElement* sink = gst_pad_get_parent_element(pad);
+    if (sink) {
+        gchar* location = nullptr;
+        g_object_get(sink, "location", &location, nullptr);
+        if (location) worker->preallocateSegment(QString::fromUtf8(location));
+        g_free(location);
+        gst_object_unref(sink);
+    }
+    return GST_PAD_PROBE_REMOVE;
+}
+
+// Reserve bitrate x duration (+10%) without changing the visible size, so the
+// fragment lands in one contiguous extent instead of growing append by append.
+void ArchiveWorker::preallocateSegment(const QString& path) {
+    const qint64 expected = recordBitrateBps / 8 * segmentDurationSec.load() * 11 / 10;
+    const QByteArray p = path.toUtf8();
+    const int fd = ::open(p.constData(), O_WRONLY | O_CLOEXEC);
+    if (fd < 0) return;
+    if (::fallocate(fd, FALLOC_FL_KEEP_SIZE, 0, expected) != 0) {
+        qWarning() << "[ArchiveWorker] fallocate failed for" << path << ":" << strerror(errno);
+    }
+    ::close(fd);
+}
+
+// Hand back the unused tail of the reservation once the fragment is closed.
+void ArchiveWorker::trimSegment(const QString& path) {
+    const QByteArray p = path.toUtf8();
+    const int fd = ::open(p.constData(), O_WRONLY | O_CLOEXEC);
+    if (fd < 0) return;
+    const off_t size = ::lseek(fd, 0, SEEK_END);
+    if (size >= 0 && ::ftruncate(fd, size) != 0) {
+        qWarning() << "[ArchiveWorker] trim failed for" << path << ":" << strerror(errno);
+    }
+    ::close(fd);
+}
+
 gchar* ArchiveWorker::formatLocationFullCallback(GstElement* splitmux, guint fragment_id, GstSample* sample, gpointer user_data) {
     Q_UNUSED(splitmux);
     Q_UNUSED(fragment_id);
     ArchiveWorker* worker = static_cast<ArchiveWorker*>(user_data);
+    MetricTimer openTimer(*worker->mSegmentOpen);
 
     QDateTime segmentStartTime;
     if (sample) {
@@ -176,7 +451,6 @@ gchar* ArchiveWorker::formatLocationFullCallback(GstElement* splitmux, guint fra
             GstClockTime pts = GST_BUFFER_PTS(buffer);
             qint64 ptsMs = pts / 1000000;
             segmentStartTime = worker->masterStart.addMSecs(ptsMs);
-            qDebug() << "[ArchiveWorker] PTS for cam" << worker->cameraIndex << ":" << pts << "ns (" << ptsMs << "ms)";
         }
     }
 
@@ -185,10 +459,14 @@ gchar* ArchiveWorker::formatLocationFullCallback(GstElement* splitmux, guint fra
         qDebug() << "[ArchiveWorker] No valid PTS for cam" << worker->cameraIndex << ", using system time";
     }
 
+    // Only report rollovers that drift more than a second from the configured duration
     if (worker->lastSegmentTimestamp.isValid()) {
-        qint64 diff = worker->lastSegmentTimestamp.msecsTo(segmentStartTime);
-        qDebug() << "[ArchiveWorker] Time since last segment for cam" << worker->cameraIndex
-                 << ":" << diff << "ms (expected:" << worker->segmentDurationSec.load()*1000 << "ms)";
+        const qint64 diff = worker->lastSegmentTimestamp.msecsTo(segmentStartTime);
+        const qint64 expected = qint64(worker->segmentDurationSec.load()) * 1000;
+        if (qAbs(diff - expected) > 1000) {
+            qDebug() << "[ArchiveWorker] Segment rollover drift for cam" << worker->cameraIndex
+                     << ":" << diff << "ms (expected:" << expected << "ms)";
+        }
     }
     worker->lastSegmentTimestamp = segmentStartTime;
 
@@ -197,7 +475,8 @@ gchar* ArchiveWorker::formatLocationFullCallback(GstElement* splitmux, guint fra
                            .arg(worker->archiveDir)
                            .arg(worker->cameraIndex)
                            .arg(timestamp);
-    qDebug() << "[ArchiveWorker] New segment:" << filename;
+    const bool reused = worker->segmentPool && worker->segmentPool->claim(filename);
+    qDebug() << "[ArchiveWorker] New segment:" << filename << (reused ? "(recycled)" : "");
 
     // --- DB notifications: close previous, open new ---
        const qint64 startNs = segmentStartTime.toUTC().toMSecsSinceEpoch() * 1000000LL;
@@ -205,6 +484,10 @@ gchar* ArchiveWorker::formatLocationFullCallback(GstElement* splitmux, guint fra
            QMutexLocker lk(&worker->curMutex);
            // finalize previous file if present
            if (!worker->currentFilePath.isEmpty() && worker->currentStartTimeUtc.isValid()) {
+               {
+                   QMutexLocker sl(&worker->statsMutex);
+                   worker->closeRequestedUs.insert(worker->currentFilePath, g_get_monotonic_time());
+               }
                const qint64 endMs = worker->currentStartTimeUtc.msecsTo(segmentStartTime);
                const qint64 endNs =
                    worker->currentStartTimeUtc.toMSecsSinceEpoch()*1000000LL + endMs*1000000LL;
@@ -231,7 +514,7 @@ gchar* ArchiveWorker::formatLocationFullCallback(GstElement* splitmux, guint fra
                      << "seconds for cam" << worker->cameraIndex;
             gst_object_unref(sink);
         } else {
-            qDebug() << "[ArchiveWorker] Failed to update segment duration: splitmuxsink not found for cam" << worker->cameraIndex;
+            qWarning() << "[ArchiveWorker] Failed to update segment duration: splitmuxsink not found for cam" << worker->cameraIndex;
         }
     }
 
@@ -243,15 +526,14 @@ gchar* ArchiveWorker::formatLocationFullCallback(GstElement* splitmux, guint fra
 }
 
 
-void ArchiveWorker::onBusMessage(GstBus* bus, GstMessage* message, gpointer user_data) {
-    Q_UNUSED(bus);
-    ArchiveWorker* worker = static_cast<ArchiveWorker*>(user_data);
+void ArchiveWorker::onBusMessage(GstMessage* message) {
+    ArchiveWorker* worker = this;
     switch (GST_MESSAGE_TYPE(message)) {
     case GST_MESSAGE_ERROR: {
         GError* err = nullptr;
         gchar* debug_info = nullptr;
         gst_message_parse_error(message, &err, &debug_info);
-        qDebug() << "[ArchiveWorker] GST ERROR for cam" << worker->cameraIndex << ":" << err->message;
+        qWarning() << "[ArchiveWorker] GST ERROR for cam" << worker->cameraIndex << ":" << err->message;
         emit worker->recordingError(err->message);
         g_error_free(err);
         g_free(debug_info);
@@ -274,16 +556,41 @@ void ArchiveWorker::onBusMessage(GstBus* bus, GstMessage* message, gpointer user
                 }
         qDebug() << "[ArchiveWorker] GST EOS received for cam" << worker->cameraIndex;
         emit worker->segmentFinalized();
+        {
+            QMutexLocker lk(&worker->runMutex);
+            worker->eosReceived = true;
+            worker->runCondition.wakeAll();
+        }
         break;
     case GST_MESSAGE_WARNING: {
         GError* err = nullptr;
         gchar* debug_info = nullptr;
         gst_message_parse_warning(message, &err, &debug_info);
-        qDebug() << "[ArchiveWorker] GST WARNING for cam" << worker->cameraIndex << ":" << err->message;
+        qWarning() << "[ArchiveWorker] GST WARNING for cam" << worker->cameraIndex << ":" << err->message;
         g_error_free(err);
         g_free(debug_info);
         break;
     }
+    case GST_MESSAGE_ELEMENT: {
+        const GstStructure* st = gst_message_get_structure(message);
+        if (st && gst_structure_has_name(st, "splitmuxsink-fragment-closed")) {
+            const gchar* location = gst_structure_get_string(st, "location");
+            if (location) {
+                const QString path = QString::fromUtf8(location);
+                qint64 requestedUs = 0;
+                {
+                    QMutexLocker lk(&worker->statsMutex);
+                    requestedUs = worker->closeRequestedUs.take(path);
+                }
+                if (requestedUs > 0) worker->mSegmentClose->observeUs(g_get_monotonic_time() - requestedUs);
+                // open/ftruncate can block: keep them off the shared bus dispatcher thread.
+                if (worker->preallocSegments)
+                    QThreadPool::globalInstance()->start([path]{ ArchiveWorker::trimSegment(path); });
+                emit worker->segmentFileClosed(worker->cameraIndex, path);
+            }
+        }
+        break;
+    }
     case GST_MESSAGE_STATE_CHANGED: {
         GstState old_state, new_state, pending;
         gst_message_parse_state_changed(message, &old_state, &new_state, &pending);
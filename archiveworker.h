@@ -8,8 +8,16 @@
 #include <QDateTime>
 #include <QMutex>
 #include <QWaitCondition>
+#include <QList>
+#include <QHash>
 #include <string>
 #include <gst/gst.h>
+#include <gst/app/gstappsink.h>
+#include "live_frame.h"
+#include "keyframe_gate.h"
+
+class SegmentFilePool;
+class MetricHistogram;
 
 class ArchiveWorker : public QThread {
     Q_OBJECT
@@ -22,14 +30,39 @@ public:
     void run() override;
     void stop();
 
+    // Shared ingest: the recorder's RTSP session also feeds the live wall via tee
+    // (recorder, 640x480 live decode, full-res branch behind a valve). Set before start().
+    void setSharedIngest(bool on) { sharedIngest = on; }
+    bool isSharedIngest() const { return sharedIngest; }
+
+    // Recycled segment files: new fragments reuse a pooled file (extents included)
+    // when one is free, written in place by SegmentSink. Owned by ArchiveManager; set before start().
+    void setSegmentPool(SegmentFilePool* pool) { segmentPool = pool; }
+
+    // Ingest counters since start(): compressed bytes/buffers leaving h264parse and
+    // RTP packets the jitterbuffers gave up on. Safe from any thread.
+    struct IngestStats {
+        quint64 bytes = 0;
+        quint64 buffers = 0;
+        quint64 packetsLost = 0;
+    };
+    IngestStats ingestStats() const;
+
 public slots:
     void updateSegmentDuration(int seconds);
+    // Opens/closes the full-resolution branch (shared ingest only).
+    void setFullResolution(bool on);
+    // Shared ingest: hidden tiles decode keyframes only; the recorder is unaffected.
+    void setLiveVisible(bool visible) { liveGate.setVisible(visible); }
 
 signals:
     void recordingError(const std::string& error);
     void segmentFinalized();
     void segmentOpened(int camIndex, QString filePath, qint64 startUtcNs);     //meta data to store in db
     void segmentClosed(int camIndex, QString filePath, qint64 endUtcNs, qint64 durationMs);//meta data to store in db
+    void segmentFileClosed(int camIndex, QString filePath);   // muxer finished writing the fragment
+    void liveFrameReady(int camIndex, const LiveFrame& frame);   // shared ingest, grid size
+    void fullFrameReady(int camIndex, const LiveFrame& frame);   // shared ingest, while full-res is on
 
 private:
     std::string cameraUrl;
@@ -45,14 +78,58 @@ private:
     QMutex updateMutex;
     QWaitCondition updateCondition;
 
+    // run() sleeps here until stop(); EOS/errors arrive via GstBusDispatcher
+    QMutex runMutex;
+    QWaitCondition runCondition;
+    bool eosReceived = false;
+    guint busWatch = 0;
+    static constexpr int kEosDrainMs = 3000;
+
     QDateTime lastSegmentTimestamp;
 
     void createPipeline();
     void cleanupPipeline();
+    bool linkSharedIngest(GstElement* parse, GstElement* split);
+    static GstFlowReturn onLiveSample(GstAppSink* sink, gpointer user_data);
+    static GstFlowReturn onFullSample(GstAppSink* sink, gpointer user_data);
+
+    bool sharedIngest = false;
+    GstElement* fullValve = nullptr;       // guarded by curMutex
+    std::atomic<qint64> liveMinIntervalUs{0};
+    std::atomic<qint64> liveLastEmitUs{0};
+    KeyframeGate liveGate;                 // on the live branch input, after the tee
     QString generateSegmentPrefix() const;
 
+    // Segment files: optional fallocate() to the expected size (trimmed on close)
+    // and optional fully buffered filesink writes (lost on a crash, so off by default).
+    //   CAMVIGIL_PREALLOC_SEGMENTS=1, CAMVIGIL_RECORD_BITRATE_KBPS (4096),
+    //   CAMVIGIL_RECORD_WRITE_BUFFER_KB (0 = filesink default; rounded down to 4 KiB)
+    SegmentFilePool* segmentPool = nullptr;
+    bool   preallocSegments = false;
+    qint64 recordBitrateBps = 0;
+    int    writeBufferBytes = 0;
+    static void onSinkAdded(GstElement* splitmux, GstElement* sink, gpointer user_data);
+    static GstPadProbeReturn onFirstSegmentBuffer(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
+    void preallocateSegment(const QString& path);
+    static void trimSegment(const QString& path);   // blocking; runs on a pool thread
+
+    // Ingest stats (see ingestStats())
+    std::atomic<quint64> ingestBytes{0};
+    std::atomic<quint64> ingestBuffers{0};
+    mutable QMutex statsMutex;
+    QList<GstElement*> jitterBuffers;      // reffed; guarded by statsMutex
+    static GstPadProbeReturn onIngestBuffer(GstPad* pad, GstPadProbeInfo* info, gpointer user_data);
+    static void onNewManager(GstElement* src, GstElement* manager, gpointer user_data);
+    static void onNewJitterBuffer(GstElement* rtpbin, GstElement* jb, guint session, guint ssrc, gpointer user_data);
+
+    // camvigil_segment_{open,close}_seconds for this camera (registry-owned).
+    // Close latency runs from the rollover (format-location) to fragment-closed.
+    MetricHistogram* mSegmentOpen = nullptr;
+    MetricHistogram* mSegmentClose = nullptr;
+    QHash<QString, qint64> closeRequestedUs;   // path -> monotonic us; guarded by statsMutex
+
     static gchar* formatLocationFullCallback(GstElement* splitmux, guint fragment_id, GstSample* sample, gpointer user_data);
-    static void onBusMessage(GstBus* bus, GstMessage* message, gpointer user_data);
+    void onBusMessage(GstMessage* message);
     QString currentFilePath;
     QDateTime currentStartTimeUtc;
     QMutex curMutex;
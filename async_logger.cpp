@@ -0,0 +1,327 @@
+#include "async_logger.h"
+#include "metrics_registry.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QStringList>
+#include <QThread>
+#include <cstdio>
+#include <cstring>
+
+static AsyncLogger* g_logger = nullptr;   // leaked on purpose: static destructors may still log
+
+// Ordered severity (QtMsgType values are not).
+static int rankOf(QtMsgType type) {
+    switch (type) {
+    case QtDebugMsg:    return 0;
+    case QtInfoMsg:     return 1;
+    case QtWarningMsg:  return 2;
+    case QtCriticalMsg: return 3;
+    case QtFatalMsg:    return 4;
+    }
+    return 1;
+}
+
+static const char* levelName(int rank) {
+    static const char* names[] = { "debug", "info", "warning", "critical", "fatal" };
+    return names[qBound(0, rank, 4)];
+}
+
+static int parseLevel(const QString& s, int fallback) {
+    const QString l = s.trimmed().toLower();
+    if (l == "debug")               return 0;
+    if (l == "info")                return 1;
+    if (l == "warning" || l == "warn") return 2;
+    if (l == "critical" || l == "error") return 3;
+    if (l == "off" || l == "none")  return 5;
+    return fallback;
+}
+
+static quint32 fnv1a(const char* s, int len) {
+    quint32 h = 2166136261u;
+    for (int i = 0; i < len; ++i) { h ^= quint8(s[i]); h *= 16777619u; }
+    return h ? h : 1;
+}
+
+AsyncLogger::AsyncLogger()
+    : ring_(new Slot[kRingSize])
+{
+    for (size_t i = 0; i < kRingSize; ++i) ring_[i].seq.store(i, std::memory_order_relaxed);
+
+    defaultLevel_ = 1;
+    const QStringList specs = qEnvironmentVariable("CAMVIGIL_LOG_LEVELS").split(',', Qt::SkipEmptyParts);
+    for (const QString& spec : specs) {
+        const int eq = spec.indexOf('=');
+        if (eq < 0) { defaultLevel_ = parseLevel(spec, defaultLevel_); continue; }
+        levelOverrides_.insert(spec.left(eq).trimmed().toUtf8(), parseLevel(spec.mid(eq + 1), defaultLevel_));
+    }
+
+    bool ok = false;
+    const int rate = qEnvironmentVariable("CAMVIGIL_LOG_RATE").toInt(&ok);
+    if (ok && rate >= 0) ratePerSec_ = rate;
+
+    logDir_ = qEnvironmentVariable("CAMVIGIL_LOG_DIR").trimmed();
+    const int maxMb = qEnvironmentVariable("CAMVIGIL_LOG_MAX_MB").toInt(&ok);
+    maxBytes_ = qint64(ok && maxMb > 0 ? maxMb : 32) * 1024 * 1024;
+    const int keep = qEnvironmentVariable("CAMVIGIL_LOG_KEEP").toInt(&ok);
+    if (ok && keep >= 1) keepFiles_ = keep;
+}
+
+void AsyncLogger::install() {
+    if (g_logger) return;
+    g_logger = new AsyncLogger();
+
+    if (!g_logger->logDir_.isEmpty()) {
+        QDir().mkpath(g_logger->logDir_);
+        g_logger->file_.setFileName(g_logger->logDir_ + "/camvigil.jsonl");
+        if (!g_logger->file_.open(QIODevice::WriteOnly | QIODevice::Append)) {
+            std::fprintf(stderr, "[Log] cannot open %s, logging to stderr\n",
+                         qPrintable(g_logger->file_.fileName()));
+        } else {
+            g_logger->fileBytes_ = g_logger->file_.size();
+        }
+    }
+
+    g_logger->writer_ = QThread::create([]{ g_logger->run_(); });
+    g_logger->writer_->setObjectName("AsyncLogger");
+    g_logger->writer_->start(QThread::LowPriority);
+    g_logger->previous_ = qInstallMessageHandler(&AsyncLogger::handler);
+}
+
+void AsyncLogger::shutdown() {
+    if (!g_logger || !g_logger->writer_) return;
+    qInstallMessageHandler(g_logger->previous_);
+    g_logger->stopping_.store(true);
+    g_logger->wake_();
+    g_logger->writer_->wait();
+    delete g_logger->writer_;
+    g_logger->writer_ = nullptr;
+    g_logger->file_.close();
+}
+
+void AsyncLogger::handler(QtMsgType type, const QMessageLogContext& ctx, const QString& msg) {
+    if (type == QtFatalMsg) {
+        // Qt aborts right after we return: flush what is queued, then this line, synchronously.
+        QMutexLocker lk(&g_logger->drainMutex_);
+        g_logger->drain_();
+        Record rec;
+        rec.tsMs = QDateTime::currentMSecsSinceEpoch();
+        rec.thread = quintptr(QThread::currentThreadId());
+        rec.level = 4;
+        rec.category = 0;
+        rec.text = msg.toUtf8();
+        g_logger->write_(rec);
+        if (g_logger->file_.isOpen()) {
+            g_logger->file_.flush();
+            std::fprintf(stderr, "%s\n", msg.toLocal8Bit().constData());
+        }
+        std::fflush(stderr);
+        return;
+    }
+    g_logger->post_(type, ctx, msg);
+}
+
+// ---------- Producer side (any thread, never blocks) ----------
+
+void AsyncLogger::post_(QtMsgType type, const QMessageLogContext& ctx, const QString& msg) {
+    const int level = rankOf(type);
+
+    // Category: explicit QLoggingCategory, else the "[Tag]" prefix used across the app.
+    QByteArray tag;
+    if (ctx.category && qstrcmp(ctx.category, "default") != 0) {
+        tag = ctx.category;
+    } else if (msg.startsWith('[')) {
+        const int end = msg.indexOf(']');
+        if (end > 1 && end < 32) tag = msg.mid(1, end - 1).toLatin1();
+    }
+    if (tag.isEmpty()) tag = "default";
+
+    const int ci = categoryFor_(tag.constData(), tag.size());
+    Category& c = categories_[ci];
+    const qint64 nowMs = QDateTime::currentMSecsSinceEpoch();
+    if (!admit_(c, level, nowMs)) return;
+
+    Record rec;
+    rec.tsMs = nowMs;
+    rec.thread = quintptr(QThread::currentThreadId());
+    rec.level = level;
+    rec.category = ci;
+    rec.text = msg.toUtf8();
+    if (!push_(std::move(rec))) { ringDropped_.fetch_add(1, std::memory_order_relaxed); return; }
+    std::atomic_thread_fence(std::memory_order_seq_cst);   // pairs with run_()'s park
+    if (sleeping_.load(std::memory_order_relaxed)) wake_();
+}
+
+// Only taken when the writer is parked, i.e. at most once per idle period.
+void AsyncLogger::wake_() {
+    QMutexLocker lk(&wakeMutex_);
+    wakeCond_.wakeOne();
+}
+
+// Open-addressed, insert-only; a full table folds new tags into slot 0.
+int AsyncLogger::categoryFor_(const char* name, int len) {
+    const int n = qMin(len, int(sizeof(Category::name)) - 1);
+    const quint32 h = fnv1a(name, n);
+    for (int probe = 0; probe < kCategories; ++probe) {
+        const int i = int((h + quint32(probe)) % kCategories);
+        Category& c = categories_[i];
+        quint32 cur = c.hash.load(std::memory_order_acquire);
+        if (cur == h) return i;
+        if (cur == 0 && c.hash.compare_exchange_strong(cur, h, std::memory_order_acq_rel)) {
+            memcpy(c.name, name, size_t(n));
+            c.name[n] = '\0';
+            c.minLevel = levelOverrides_.value(QByteArray(c.name), defaultLevel_);
+            c.ready.store(true, std::memory_order_release);
+            return i;
+        }
+        if (cur == h) return i;   // lost the race to the same tag
+    }
+    return 0;
+}
+
+bool AsyncLogger::admit_(Category& c, int level, qint64 nowMs) {
+    const int minLevel = c.ready.load(std::memory_order_acquire) ? c.minLevel : defaultLevel_;
+    if (level < minLevel) return false;
+    if (ratePerSec_ <= 0 || level >= 3) return true;
+
+    // Fixed one-second window per category.
+    qint64 start = c.windowMs.load(std::memory_order_relaxed);
+    if (nowMs - start >= 1000 && c.windowMs.compare_exchange_strong(start, nowMs, std::memory_order_relaxed)) {
+        c.inWindow.store(0, std::memory_order_relaxed);
+    }
+    if (c.inWindow.fetch_add(1, std::memory_order_relaxed) < ratePerSec_) return true;
+    c.dropped.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+// Bounded MPMC ring (per-slot sequence numbers); used here with a single consumer.
+bool AsyncLogger::push_(Record&& rec) {
+    size_t pos = head_.load(std::memory_order_relaxed);
+    Slot* slot = nullptr;
+    for (;;) {
+        slot = &ring_[pos & (kRingSize - 1)];
+        const size_t seq = slot->seq.load(std::memory_order_acquire);
+        const qint64 dif = qint64(seq) - qint64(pos);
+        if (dif == 0) {
+            if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        } else if (dif < 0) {
+            return false;   // full
+        } else {
+            pos = head_.load(std::memory_order_relaxed);
+        }
+    }
+    slot->rec = std::move(rec);
+    slot->seq.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+bool AsyncLogger::pop_(Record& rec) {
+    Slot& slot = ring_[tail_ & (kRingSize - 1)];
+    if (slot.seq.load(std::memory_order_acquire) != tail_ + 1) return false;
+    rec = std::move(slot.rec);
+    slot.seq.store(tail_ + kRingSize, std::memory_order_release);
+    ++tail_;
+    return true;
+}
+
+// ---------- Writer thread ----------
+
+void AsyncLogger::run_() {
+    qint64 lastReportMs = QDateTime::currentMSecsSinceEpoch();
+    for (;;) {
+        const bool stop = stopping_.load();
+        {
+            QMutexLocker lk(&drainMutex_);
+            const int n = drain_();
+            const qint64 now = QDateTime::currentMSecsSinceEpoch();
+            if (stop || now - lastReportMs >= 1000) { reportDrops_(); lastReportMs = now; }
+            if (n > 0) {
+                if (file_.isOpen()) file_.flush();
+                else std::fflush(stderr);
+            }
+        }
+        if (stop) break;
+
+        // Park until a producer pushes. sleeping_ is published before the ring is
+        // re-checked, so a push either lands in that check or sees sleeping_ and wakes us.
+        QMutexLocker lk(&wakeMutex_);
+        sleeping_.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        bool idle = false;
+        {
+            QMutexLocker dl(&drainMutex_);
+            idle = ring_[tail_ & (kRingSize - 1)].seq.load(std::memory_order_acquire) != tail_ + 1;
+        }
+        if (idle && !stopping_.load()) wakeCond_.wait(&wakeMutex_, 1000);
+        sleeping_.store(false, std::memory_order_relaxed);
+    }
+}
+
+int AsyncLogger::drain_() {
+    Record rec;
+    int n = 0;
+    while (pop_(rec)) { write_(rec); ++n; }
+    return n;
+}
+
+void AsyncLogger::write_(const Record& rec) {
+    if (!file_.isOpen()) {
+        std::fwrite(rec.text.constData(), 1, size_t(rec.text.size()), stderr);
+        std::fputc('\n', stderr);
+        return;
+    }
+    const Category& c = categories_[rec.category];
+    QJsonObject o;
+    o.insert("ts", QDateTime::fromMSecsSinceEpoch(rec.tsMs, Qt::UTC).toString(Qt::ISODateWithMs));
+    o.insert("level", levelName(rec.level));
+    o.insert("cat", QString::fromLatin1(c.ready.load(std::memory_order_acquire) ? c.name : "default"));
+    o.insert("thread", QString::number(quint64(rec.thread), 16));
+    o.insert("msg", QString::fromUtf8(rec.text));
+    QByteArray line = QJsonDocument(o).toJson(QJsonDocument::Compact);
+    line += '\n';
+    file_.write(line);
+    fileBytes_ += line.size();
+    if (fileBytes_ >= maxBytes_) rotate_();
+}
+
+// camvigil.jsonl -> .1 -> .2 ... ; the oldest beyond keepFiles_ is removed.
+void AsyncLogger::rotate_() {
+    const QString base = file_.fileName();
+    file_.close();
+    QFile::remove(base + "." + QString::number(keepFiles_));
+    for (int i = keepFiles_ - 1; i >= 1; --i)
+        QFile::rename(base + "." + QString::number(i), base + "." + QString::number(i + 1));
+    QFile::rename(base, base + ".1");
+    file_.setFileName(base);
+    fileBytes_ = 0;
+    if (!file_.open(QIODevice::WriteOnly | QIODevice::Append))
+        std::fprintf(stderr, "[Log] cannot reopen %s after rotation\n", qPrintable(base));
+}
+
+void AsyncLogger::reportDrops_() {
+    static MetricCounter& droppedTotal = MetricsRegistry::instance().counter(
+        "camvigil_log_dropped_total", "Log lines dropped by rate limits or a full ring");
+
+    quint64 total = ringDropped_.exchange(0);
+    QStringList parts;
+    if (total) parts << QString("ring-full=%1").arg(total);
+    for (Category& c : categories_) {
+        if (!c.ready.load(std::memory_order_acquire)) continue;
+        const quint64 d = c.dropped.exchange(0);
+        if (!d) continue;
+        total += d;
+        parts << QString("%1=%2").arg(QString::fromLatin1(c.name)).arg(d);
+    }
+    if (!total) return;
+    droppedTotal.inc(total);
+
+    Record rec;
+    rec.tsMs = QDateTime::currentMSecsSinceEpoch();
+    rec.thread = quintptr(QThread::currentThreadId());
+    rec.level = 2;
+    rec.category = categoryFor_("Log", 3);
+    rec.text = QString("[Log] dropped %1 lines (%2)").arg(total).arg(parts.join(", ")).toUtf8();
+    write_(rec);
+}
@@ -0,0 +1,110 @@
+#pragma once
+#include <QByteArray>
+#include <QFile>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QWaitCondition>
+#include <QtGlobal>
+#include <atomic>
+#include <memory>
+
+class QThread;
+
+/**
+ * async_logger
+ * ------------
+ * Process-wide qInstallMessageHandler backend; qDebug/qInfo/qWarning call sites
+ * stay as they are.
+ * - the handler never blocks: records go into a bounded lock-free ring and a
+ *   writer thread formats and writes them; a full ring drops (and counts) lines.
+ *   The writer sleeps until a producer wakes it (or 1 s passes, for drop reports)
+ * - qFatal drains the ring synchronously before Qt aborts, so the lines leading
+ *   up to it are not lost
+ * - the category is the QLoggingCategory name, or the leading "[Tag]" of the
+ *   message for the default category ("[Purge] ..." -> Purge)
+ * - per-category minimum level and lines-per-second cap; warnings and above are
+ *   still rate limited, criticals are not
+ * - output: plain text on stderr, or JSON lines with size-based rotation when
+ *   CAMVIGIL_LOG_DIR is set
+ *
+ * The default level is info: plain qDebug() lines are dropped unless enabled,
+ * e.g. CAMVIGIL_LOG_LEVELS=debug restores the previous everything-on output.
+ *
+ * Env:
+ *   CAMVIGIL_LOG_LEVELS  "info,SegIndex=warning,Purge=debug" (default level first)
+ *   CAMVIGIL_LOG_RATE    lines per second per category (200, 0 = unlimited)
+ *   CAMVIGIL_LOG_DIR     directory for camvigil.jsonl (unset = stderr)
+ *   CAMVIGIL_LOG_MAX_MB  rotate after this many MiB (32); CAMVIGIL_LOG_KEEP files (5)
+ */
+class AsyncLogger {
+public:
+    static void install();     // call first thing in main()
+    static void shutdown();    // drains the ring and restores the previous handler
+
+private:
+    AsyncLogger();
+    ~AsyncLogger() = default;
+    Q_DISABLE_COPY(AsyncLogger)
+
+    struct Category {
+        std::atomic<quint32> hash{0};          // 0 = free slot
+        char name[32] = {};
+        std::atomic<bool> ready{false};        // name/minLevel published
+        int minLevel = 0;
+        std::atomic<qint64> windowMs{0};
+        std::atomic<int> inWindow{0};
+        std::atomic<quint64> dropped{0};
+    };
+    struct Record {
+        qint64 tsMs = 0;
+        quintptr thread = 0;
+        int level = 0;
+        int category = 0;
+        QByteArray text;
+    };
+    struct Slot {
+        std::atomic<size_t> seq{0};
+        Record rec;
+    };
+
+    static void handler(QtMsgType type, const QMessageLogContext& ctx, const QString& msg);
+    void post_(QtMsgType type, const QMessageLogContext& ctx, const QString& msg);
+    int  categoryFor_(const char* name, int len);
+    bool admit_(Category& c, int level, qint64 nowMs);
+    bool push_(Record&& rec);
+    bool pop_(Record& rec);
+    void run_();
+    int  drain_();                              // caller holds drainMutex_
+    void wake_();
+    void write_(const Record& rec);
+    void rotate_();
+    void reportDrops_();
+
+    static constexpr int kCategories = 128;
+    static constexpr size_t kRingSize = 8192;   // power of two
+
+    Category categories_[kCategories];
+    std::unique_ptr<Slot[]> ring_;
+    std::atomic<size_t> head_{0};               // producers
+    size_t tail_ = 0;                           // consumer side, under drainMutex_
+    std::atomic<quint64> ringDropped_{0};
+
+    // Immutable after install()
+    int defaultLevel_ = 0;
+    QHash<QByteArray, int> levelOverrides_;
+    int ratePerSec_ = 200;
+    QString logDir_;
+    qint64 maxBytes_ = 0;
+    int keepFiles_ = 5;
+
+    QFile file_;                                // under drainMutex_
+    qint64 fileBytes_ = 0;                      // size of file_, tracked per write
+    QMutex drainMutex_;                         // single consumer: writer thread or qFatal
+    QMutex wakeMutex_;
+    QWaitCondition wakeCond_;
+    std::atomic<bool> sleeping_{false};         // writer is (about to be) waiting
+    QThread* writer_ = nullptr;
+    std::atomic<bool> stopping_{false};
+    QtMessageHandler previous_ = nullptr;
+};
@@ -0,0 +1,6 @@
+# Standalone benchmark harnesses (not part of the application build).
+#   qmake bench/bench.pro && make
+TEMPLATE = subdirs
+SUBDIRS += \
+    live_bench \
+    record_bench
@@ -0,0 +1,21 @@
+# Shared settings for the benchmark targets: application sources are compiled
+# straight from the repo root, synthetic cameras come from gst-rtsp-server.
+QT += core gui sql network
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000
+
+CONFIG += link_pkgconfig
+PKGCONFIG += gstreamer-1.0 gstreamer-video-1.0 gstreamer-app-1.0 gstreamer-rtsp-server-1.0 glib-2.0
+
+CAMVIGIL_ROOT = $$PWD/../..
+INCLUDEPATH += $$CAMVIGIL_ROOT $$PWD
+
+SOURCES += \
+    $$PWD/synthetic_rtsp_server.cpp
+
+HEADERS += \
+    $$PWD/bench_stats.h \
+    $$PWD/frame_stamp.h \
+    $$PWD/synthetic_rtsp_server.h
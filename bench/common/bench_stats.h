@@ -0,0 +1,51 @@
+#pragma once
+#include <QJsonObject>
+#include <QVector>
+#include <algorithm>
+#include <sys/resource.h>
+
+/**
+ * bench_stats
+ * -----------
+ * Small helpers shared by the benchmark targets.
+ * - LatencyStats: collects samples (ms) and reports count/mean/p50/p95/p99/max
+ * - cpuSeconds(): user+system CPU of this process (the synthetic server runs
+ *   in a child process, so it is not counted)
+ */
+namespace bench {
+
+inline double cpuSeconds() {
+    rusage ru{};
+    getrusage(RUSAGE_SELF, &ru);
+    return double(ru.ru_utime.tv_sec + ru.ru_stime.tv_sec)
+         + double(ru.ru_utime.tv_usec + ru.ru_stime.tv_usec) / 1e6;
+}
+
+struct LatencyStats {
+    QVector<double> samples;
+
+    void add(double ms) { samples.push_back(ms); }
+
+    static double percentile(const QVector<double>& sorted, double p) {
+        if (sorted.isEmpty()) return 0.0;
+        const int idx = qBound(0, int(p * (sorted.size() - 1) + 0.5), sorted.size() - 1);
+        return sorted[idx];
+    }
+
+    QJsonObject toJson() const {
+        QVector<double> s = samples;
+        std::sort(s.begin(), s.end());
+        double sum = 0.0;
+        for (double v : s) sum += v;
+        QJsonObject o;
+        o["count"] = s.size();
+        o["mean_ms"] = s.isEmpty() ? 0.0 : sum / s.size();
+        o["p50_ms"] = percentile(s, 0.50);
+        o["p95_ms"] = percentile(s, 0.95);
+        o["p99_ms"] = percentile(s, 0.99);
+        o["max_ms"] = s.isEmpty() ? 0.0 : s.last();
+        return o;
+    }
+};
+
+} // namespace bench
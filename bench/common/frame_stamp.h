@@ -0,0 +1,61 @@
+#pragma once
+#include <QtGlobal>
+#include <cstdint>
+
+/**
+ * frame_stamp
+ * -----------
+ * Wall-clock stamp burned into the picture so latency survives encode,
+ * RTP, decode and scaling.
+ * - 48 cells (8 x 6) in the top-left quarter: 44 bits of Unix ms + 4-bit check
+ * - cells are 1/32 x 1/24 of the frame, so a 1080p source still reads back
+ *   after the 640x480 live scale
+ * - the writer paints luma (I420/NV12 plane 0); the reader takes any
+ *   luma(x, y) accessor, so RGB frames can pass their green channel
+ */
+namespace bench {
+
+constexpr int kStampCols = 8;
+constexpr int kStampRows = 6;
+constexpr int kStampValueBits = 44;
+
+inline quint64 stampWord(quint64 ms) {
+    const quint64 v = ms & ((quint64(1) << kStampValueBits) - 1);
+    const quint64 check = quint64(__builtin_popcountll(v) & 0xF);
+    return (v << 4) | check;
+}
+
+inline void writeStamp(uint8_t* luma, int stride, int width, int height, quint64 ms) {
+    const quint64 word = stampWord(ms);
+    const int cw = qMax(1, width / 32), ch = qMax(1, height / 24);
+    for (int bit = 0; bit < kStampCols * kStampRows; ++bit) {
+        const uint8_t v = ((word >> bit) & 1) ? 235 : 16;
+        const int x0 = (bit % kStampCols) * cw, y0 = (bit / kStampCols) * ch;
+        for (int y = y0; y < y0 + ch && y < height; ++y)
+            for (int x = x0; x < x0 + cw && x < width; ++x)
+                luma[y * stride + x] = v;
+    }
+}
+
+// Returns false when the check nibble doesn't match (no stamp / too damaged).
+template <class LumaAt>
+bool readStamp(int width, int height, LumaAt lumaAt, quint64* ms) {
+    const int cw = qMax(1, width / 32), ch = qMax(1, height / 24);
+    quint64 word = 0;
+    for (int bit = 0; bit < kStampCols * kStampRows; ++bit) {
+        const int cx = (bit % kStampCols) * cw + cw / 2;
+        const int cy = (bit / kStampCols) * ch + ch / 2;
+        if (lumaAt(cx, cy) >= 128) word |= (quint64(1) << bit);
+    }
+    const quint64 v = word >> 4;
+    if (stampWord(v) != word) return false;
+    *ms = v;
+    return true;
+}
+
+// Unix ms truncated the same way as the stamp.
+inline quint64 stampNow(quint64 unixMs) {
+    return unixMs & ((quint64(1) << kStampValueBits) - 1);
+}
+
+} // namespace bench
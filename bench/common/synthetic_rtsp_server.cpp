@@ -0,0 +1,103 @@
+#include "synthetic_rtsp_server.h"
+#include <QDebug>
+#include <gst/gst.h>
+#include <gst/video/video.h>
+#include <gst/rtsp-server/rtsp-server.h>
+#include "frame_stamp.h"
+
+namespace {
+
+GstPadProbeReturn stampProbe(GstPad* pad, GstPadProbeInfo* info, gpointer) {
+    GstBuffer* buf = gst_buffer_make_writable(GST_PAD_PROBE_INFO_BUFFER(info));
+    GST_PAD_PROBE_INFO_DATA(info) = buf;
+    GstCaps* caps = gst_pad_get_current_caps(pad);
+    GstVideoInfo vi;
+    if (caps && gst_video_info_from_caps(&vi, caps)) {
+        GstVideoFrame f;
+        if (gst_video_frame_map(&f, &vi, buf, GST_MAP_WRITE)) {
+            bench::writeStamp(static_cast<uint8_t*>(GST_VIDEO_FRAME_PLANE_DATA(&f, 0)),
+                              GST_VIDEO_FRAME_PLANE_STRIDE(&f, 0),
+                              GST_VIDEO_FRAME_WIDTH(&f), GST_VIDEO_FRAME_HEIGHT(&f),
+                              quint64(g_get_real_time() / 1000));
+            gst_video_frame_unmap(&f);
+        }
+    }
+    if (caps) gst_caps_unref(caps);
+    return GST_PAD_PROBE_OK;
+}
+
+} // namespace
+
+// Stamp right before the encoder, i.e. as late as the "camera" can.
+void SyntheticRtspServer::onMediaConfigure(void* factory, void* media, void* user_data) {
+    Q_UNUSED(factory); Q_UNUSED(user_data);
+    GstElement* bin = gst_rtsp_media_get_element(GST_RTSP_MEDIA(media));
+    if (!bin) return;
+    if (GstElement* stamp = gst_bin_get_by_name_recurse_up(GST_BIN(bin), "stamp")) {
+        GstPad* src = gst_element_get_static_pad(stamp, "src");
+        gst_pad_add_probe(src, GST_PAD_PROBE_TYPE_BUFFER, stampProbe, nullptr, nullptr);
+        gst_object_unref(src);
+        gst_object_unref(stamp);
+    }
+    gst_object_unref(bin);
+}
+
+QString SyntheticRtspServer::launchDescription_(int cam) const {
+    // Distinct pattern per camera keeps the encoders from producing identical streams.
+    static const char* kPatterns[] = { "ball", "smpte", "snow", "pinwheel", "gamut", "spokes" };
+    const char* pattern = kPatterns[cam % int(sizeof(kPatterns) / sizeof(kPatterns[0]))];
+    return QString("( videotestsrc is-live=true pattern=%1 "
+                   "! video/x-raw,format=I420,width=%2,height=%3,framerate=%4/1 "
+                   "! identity name=stamp "
+                   "! x264enc tune=zerolatency speed-preset=ultrafast bitrate=%5 key-int-max=%6 "
+                   "! h264parse ! rtph264pay name=pay0 pt=96 config-interval=1 )")
+        .arg(pattern).arg(cfg_.width).arg(cfg_.height).arg(cfg_.fps)
+        .arg(cfg_.bitrateKbps).arg(cfg_.gopFrames);
+}
+
+bool SyntheticRtspServer::start() {
+    gst_init(nullptr, nullptr);
+    GstRTSPServer* server = gst_rtsp_server_new();
+    gst_rtsp_server_set_service(server, QByteArray::number(cfg_.port).constData());
+    GstRTSPMountPoints* mounts = gst_rtsp_server_get_mount_points(server);
+
+    for (int i = 0; i < cfg_.cameras; ++i) {
+        GstRTSPMediaFactory* factory = gst_rtsp_media_factory_new();
+        gst_rtsp_media_factory_set_launch(factory, launchDescription_(i).toUtf8().constData());
+        gst_rtsp_media_factory_set_shared(factory, TRUE);
+        if (cfg_.stampClock)
+            g_signal_connect(factory, "media-configure", G_CALLBACK(SyntheticRtspServer::onMediaConfigure), nullptr);
+        gst_rtsp_mount_points_add_factory(mounts, QString("/cam%1").arg(i).toUtf8().constData(), factory);
+    }
+    g_object_unref(mounts);
+
+    if (gst_rtsp_server_attach(server, nullptr) == 0) {
+        qWarning() << "[Bench] RTSP server could not bind port" << cfg_.port;
+        g_object_unref(server);
+        return false;
+    }
+    qDebug() << "[Bench] serving" << cfg_.cameras << "synthetic cameras on port" << cfg_.port
+             << QString("%1x%2@%3 %4 kbps").arg(cfg_.width).arg(cfg_.height).arg(cfg_.fps).arg(cfg_.bitrateKbps);
+    return true;   // server stays alive for the process lifetime
+}
+
+QStringList SyntheticRtspServer::serveArgs(const Config& cfg) {
+    return { "--serve",
+             "--cameras", QString::number(cfg.cameras),
+             "--port",    QString::number(cfg.port),
+             "--width",   QString::number(cfg.width),
+             "--height",  QString::number(cfg.height),
+             "--fps",     QString::number(cfg.fps),
+             "--bitrate", QString::number(cfg.bitrateKbps),
+             "--gop",     QString::number(cfg.gopFrames) }
+         + (cfg.stampClock ? QStringList{ "--stamp" } : QStringList{});
+}
+
+int SyntheticRtspServer::runServe(const Config& cfg) {
+    SyntheticRtspServer server(cfg);
+    if (!server.start()) return 1;
+    GMainLoop* loop = g_main_loop_new(nullptr, FALSE);
+    g_main_loop_run(loop);
+    g_main_loop_unref(loop);
+    return 0;
+}
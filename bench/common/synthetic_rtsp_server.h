@@ -0,0 +1,44 @@
+#pragma once
+#include <QString>
+#include <QStringList>
+
+/**
+ * SyntheticRtspServer
+ * -------------------
+ * gst-rtsp-server serving N independent test cameras, no hardware needed.
+ * - rtsp://127.0.0.1:<port>/cam<i>, one videotestsrc ! x264enc per mount
+ *   (shared between clients, so sub + main consumers cost one encoder)
+ * - optional wall-clock stamp in every frame (frame_stamp.h) for latency runs
+ * - runs on the default GMainContext; the caller spins the main loop
+ * - benches start it in a child process (--serve) so the encoders' CPU
+ *   never shows up in the recorder/viewer measurements
+ */
+class SyntheticRtspServer {
+public:
+    struct Config {
+        int cameras     = 4;
+        int port        = 8554;
+        int width       = 1920;
+        int height      = 1080;
+        int fps         = 25;
+        int bitrateKbps = 4096;
+        int gopFrames   = 50;
+        bool stampClock = false;
+    };
+
+    explicit SyntheticRtspServer(const Config& cfg) : cfg_(cfg) {}
+
+    bool start();                                // false if the port can't be bound
+
+    static QString urlFor(int port, int cam) {
+        return QString("rtsp://127.0.0.1:%1/cam%2").arg(port).arg(cam);
+    }
+    // Arguments that make a child process serve the same configuration.
+    static QStringList serveArgs(const Config& cfg);
+    static int runServe(const Config& cfg);      // blocking (g_main_loop_run)
+
+private:
+    QString launchDescription_(int cam) const;
+    static void onMediaConfigure(void* factory, void* media, void* user_data);
+    Config cfg_;
+};
@@ -0,0 +1,30 @@
+# Live-view latency benchmark: StreamWorker -> StreamManager -> tile, headless.
+TARGET = live_bench
+include(../common/bench_common.pri)
+QT += widgets
+
+LIBS += -lGL
+
+SOURCES += \
+    main.cpp \
+    $$CAMVIGIL_ROOT/gl_video_texture.cpp \
+    $$CAMVIGIL_ROOT/glcontainerwidget.cpp \
+    $$CAMVIGIL_ROOT/gst_bus_dispatcher.cpp \
+    $$CAMVIGIL_ROOT/metrics_registry.cpp \
+    $$CAMVIGIL_ROOT/rtsp_probe.cpp \
+    $$CAMVIGIL_ROOT/stream_supervisor.cpp \
+    $$CAMVIGIL_ROOT/streammanager.cpp \
+    $$CAMVIGIL_ROOT/streamworker.cpp
+
+HEADERS += \
+    $$CAMVIGIL_ROOT/camerastreams.h \
+    $$CAMVIGIL_ROOT/gl_video_texture.h \
+    $$CAMVIGIL_ROOT/glcontainerwidget.h \
+    $$CAMVIGIL_ROOT/gst_bus_dispatcher.h \
+    $$CAMVIGIL_ROOT/keyframe_gate.h \
+    $$CAMVIGIL_ROOT/live_frame.h \
+    $$CAMVIGIL_ROOT/metrics_registry.h \
+    $$CAMVIGIL_ROOT/rtsp_probe.h \
+    $$CAMVIGIL_ROOT/stream_supervisor.h \
+    $$CAMVIGIL_ROOT/streammanager.h \
+    $$CAMVIGIL_ROOT/streamworker.h
@@ -0,0 +1,320 @@
+// live_bench: what does the live wall cost, and how late is it?
+//
+// Serves N synthetic cameras (child process) with a wall-clock stamp burned into
+// every frame, runs the real StreamManager/StreamWorker path into the real tile
+// sink, and reports after a warm-up:
+//   - glass-to-glass latency: stamp (before encode) -> tile drawn (GL grid: after
+//     paintGL + glFinish; pixmap wall: after the label repaint)
+//   - delivered fps per tile, frames that never reached a paint
+//   - C++ heap allocations per delivered frame (operator new, whole process)
+//   - CPU per tile (this process only; encoders run in the child)
+// Runs offscreen (QT_QPA_PLATFORM=offscreen unless already set). Without a GL
+// context the grid falls back to measuring at delivery ("measured_at" says which).
+// Results go to stdout as JSON (and --json <file>) for comparison across commits.
+//
+//   live_bench --cameras 16 --width 1280 --height 720 --duration 60 --json run.json
+//   CAMVIGIL_LIVE_HANDOFF=pixmap live_bench ...   # old QLabel path
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QGridLayout>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLabel>
+#include <QOpenGLContext>
+#include <QOpenGLFunctions>
+#include <QPixmap>
+#include <QProcess>
+#include <QTcpSocket>
+#include <QThread>
+#include <QTimer>
+#include <QVector>
+#include <QDebug>
+#include <gst/gst.h>
+#include <gst/video/video.h>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#include "streammanager.h"
+#include "glcontainerwidget.h"
+#include "bench_stats.h"
+#include "frame_stamp.h"
+#include "synthetic_rtsp_server.h"
+
+// ---- allocation counter (C++ heap only; GStreamer's g_malloc is not seen) ----
+static std::atomic<quint64> g_allocs{0};
+
+void* operator new(std::size_t n) {
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+struct TileStats {
+    quint64 delivered = 0;       // frames handed to the tile
+    quint64 drawn = 0;           // frames that made it into a paint
+    quint64 unstamped = 0;       // stamp unreadable
+    quint64 pendingStampMs = 0;  // newest undrawn frame's stamp (0 = none)
+};
+
+struct Run {
+    std::vector<TileStats> tiles;
+    bench::LatencyStats latency;
+    bool measuring = false;
+};
+
+quint64 nowStampMs() {
+    return bench::stampNow(quint64(QDateTime::currentMSecsSinceEpoch()));
+}
+
+bool readFrameStamp(const LiveFrame& frame, quint64* ms) {
+    GstVideoInfo info;
+    if (!frame.videoInfo(&info)) return false;
+    GstVideoFrame vf;
+    if (!gst_video_frame_map(&vf, &info, frame.buffer(), GST_MAP_READ)) return false;
+    const auto* p = static_cast<const uint8_t*>(GST_VIDEO_FRAME_PLANE_DATA(&vf, 0));
+    const int stride = GST_VIDEO_FRAME_PLANE_STRIDE(&vf, 0);
+    const bool rgb = GST_VIDEO_INFO_FORMAT(&info) == GST_VIDEO_FORMAT_RGB;
+    const bool ok = bench::readStamp(GST_VIDEO_FRAME_WIDTH(&vf), GST_VIDEO_FRAME_HEIGHT(&vf),
+        [&](int x, int y){ return rgb ? int(p[y * stride + x * 3 + 1]) : int(p[y * stride + x]); }, ms);
+    gst_video_frame_unmap(&vf);
+    return ok;
+}
+
+bool readImageStamp(const QImage& img, quint64* ms) {
+    return bench::readStamp(img.width(), img.height(),
+        [&](int x, int y){ return qGreen(img.pixel(x, y)); }, ms);
+}
+
+void recordDraw(Run& run, TileStats& t) {
+    if (!t.pendingStampMs) return;
+    if (run.measuring) {
+        const qint64 lat = qint64(nowStampMs()) - qint64(t.pendingStampMs);
+        if (lat >= 0 && lat < 60000) run.latency.add(double(lat));
+        ++t.drawn;
+    }
+    t.pendingStampMs = 0;
+}
+
+// The real GL grid; a frame counts as drawn once its tile's paint has finished on the GPU.
+class BenchWall : public GLContainerWidget {
+public:
+    explicit BenchWall(Run& run) : run_(run) {}
+protected:
+    void paintGL() override {
+        GLContainerWidget::paintGL();
+        context()->functions()->glFinish();
+        for (auto& t : run_.tiles) recordDraw(run_, t);
+    }
+private:
+    Run& run_;
+};
+
+bool waitForPort(int port, int timeoutMs) {
+    QElapsedTimer t; t.start();
+    while (t.elapsed() < timeoutMs) {
+        QTcpSocket s;
+        s.connectToHost("127.0.0.1", quint16(port));
+        if (s.waitForConnected(200)) return true;
+        QThread::msleep(100);
+    }
+    return false;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    // Headless by default (build machines); an explicit platform wins.
+    const bool serveOnly = argc > 1 && qstrcmp(argv[1], "--serve") == 0;
+    if (!serveOnly && qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+    QCommandLineParser cli;
+    cli.setApplicationDescription("CamVigil live-view latency benchmark");
+    cli.addHelpOption();
+    const QCommandLineOption serveOpt("serve", "Internal: run only the synthetic RTSP server.");
+    const QCommandLineOption stampOpt("stamp", "Internal: stamp frames with the wall clock.");
+    const QCommandLineOption camsOpt("cameras", "Number of cameras/tiles.", "n", "4");
+    const QCommandLineOption durOpt("duration", "Measured seconds (after warm-up).", "s", "30");
+    const QCommandLineOption warmOpt("warmup", "Warm-up seconds excluded from results.", "s", "5");
+    const QCommandLineOption widthOpt("width", "Source width.", "px", "1280");
+    const QCommandLineOption heightOpt("height", "Source height.", "px", "720");
+    const QCommandLineOption fpsOpt("fps", "Source frame rate.", "fps", "25");
+    const QCommandLineOption rateOpt("bitrate", "Source bitrate (kbps).", "kbps", "2048");
+    const QCommandLineOption gopOpt("gop", "Keyframe interval in frames (0 = 2 s).", "frames", "0");
+    const QCommandLineOption portOpt("port", "RTSP port.", "port", "8555");
+    const QCommandLineOption jsonOpt("json", "Also write the result JSON here.", "file");
+    cli.addOptions({ serveOpt, stampOpt, camsOpt, durOpt, warmOpt, widthOpt, heightOpt,
+                     fpsOpt, rateOpt, gopOpt, portOpt, jsonOpt });
+    cli.process(app);
+
+    SyntheticRtspServer::Config src;
+    src.cameras     = qMax(1, cli.value(camsOpt).toInt());
+    src.port        = cli.value(portOpt).toInt();
+    src.width       = cli.value(widthOpt).toInt();
+    src.height      = cli.value(heightOpt).toInt();
+    src.fps         = qMax(1, cli.value(fpsOpt).toInt());
+    src.bitrateKbps = cli.value(rateOpt).toInt();
+    src.gopFrames   = cli.value(gopOpt).toInt() > 0 ? cli.value(gopOpt).toInt() : src.fps * 2;
+    src.stampClock  = cli.isSet(stampOpt);
+
+    if (cli.isSet(serveOpt)) return SyntheticRtspServer::runServe(src);
+    // Latency is read from the stamp, so the measuring side always asks its child for it.
+    src.stampClock  = true;
+
+    gst_init(&argc, &argv);
+    const int warmupSec   = qMax(0, cli.value(warmOpt).toInt());
+    const int durationSec = qMax(1, cli.value(durOpt).toInt());
+
+    QProcess server;
+    server.setProcessChannelMode(QProcess::ForwardedErrorChannel);
+    server.start(QCoreApplication::applicationFilePath(), SyntheticRtspServer::serveArgs(src));
+    if (!server.waitForStarted(5000) || !waitForPort(src.port, 10000)) {
+        qCritical() << "[Bench] synthetic RTSP server did not come up";
+        return 1;
+    }
+
+    Run run;
+    run.tiles.resize(size_t(src.cameras));
+    const int cols = int(std::ceil(std::sqrt(double(src.cameras))));
+    const int rows = (src.cameras + cols - 1) / cols;
+
+    StreamManager sm;
+    const FrameHandoff handoff = sm.handoff();
+    QString measuredAt = "render";
+
+    // --- tile sinks, as MainWindow wires them ---
+    BenchWall* wall = nullptr;
+    QWidget labelWall;
+    QVector<QLabel*> labels;
+    if (handoff == FrameHandoff::Sample) {
+        wall = new BenchWall(run);
+        wall->resize(1920, 1080);
+        wall->setGrid(src.cameras, rows, cols);
+        wall->show();
+        QCoreApplication::processEvents();
+        if (!wall->context() || !wall->context()->isValid()) {
+            qWarning() << "[Bench] no GL context on this platform; measuring at delivery";
+            measuredAt = "delivery";
+        }
+        QObject::connect(&sm, &StreamManager::sampleReady, wall, [&](int idx, const LiveFrame& frame){
+            if (idx < 0 || idx >= src.cameras) return;
+            TileStats& t = run.tiles[size_t(idx)];
+            if (run.measuring) ++t.delivered;
+            quint64 ms = 0;
+            if (!readFrameStamp(frame, &ms)) { if (run.measuring) ++t.unstamped; return; }
+            t.pendingStampMs = ms;           // a newer frame replaces an undrawn one, like the grid
+            if (measuredAt == "delivery") recordDraw(run, t);
+            else wall->presentFrame(idx, frame);
+        });
+    } else {
+        auto* grid = new QGridLayout(&labelWall);
+        for (int i = 0; i < src.cameras; ++i) {
+            auto* l = new QLabel(&labelWall);
+            l->setMinimumSize(160, 120);
+            grid->addWidget(l, i / cols, i % cols);
+            labels.push_back(l);
+        }
+        labelWall.resize(1920, 1080);
+        labelWall.show();
+        QObject::connect(&sm, &StreamManager::frameReady, &labelWall, [&](int idx, const QPixmap& pm){
+            if (idx < 0 || idx >= labels.size()) return;
+            TileStats& t = run.tiles[size_t(idx)];
+            if (run.measuring) ++t.delivered;
+            labels[idx]->setPixmap(pm);
+            labels[idx]->repaint();
+            quint64 ms = 0;
+            if (!readImageStamp(pm.toImage(), &ms)) { if (run.measuring) ++t.unstamped; return; }
+            t.pendingStampMs = ms;
+            recordDraw(run, t);
+        });
+    }
+
+    std::vector<CamHWProfile> profiles;
+    for (int i = 0; i < src.cameras; ++i) {
+        const std::string url = SyntheticRtspServer::urlFor(src.port, i).toStdString();
+        profiles.emplace_back(url, url, "Bench " + std::to_string(i));
+    }
+    sm.startStreaming(profiles);
+
+    // --- measurement window ---
+    QElapsedTimer clock;
+    double cpu0 = 0.0;
+    quint64 allocs0 = 0;
+    QTimer::singleShot(warmupSec * 1000, &app, [&]{
+        cpu0 = bench::cpuSeconds();
+        allocs0 = g_allocs.load();
+        clock.start();
+        run.measuring = true;
+        QTimer::singleShot(durationSec * 1000, &app, &QCoreApplication::quit);
+    });
+    app.exec();
+
+    run.measuring = false;
+    const double wallS  = clock.elapsed() / 1000.0;
+    const double cpuS   = bench::cpuSeconds() - cpu0;
+    const quint64 allocs = g_allocs.load() - allocs0;
+
+    sm.stopStreaming();
+    delete wall;
+    server.terminate();
+    server.waitForFinished(3000);
+
+    quint64 delivered = 0, drawn = 0, unstamped = 0;
+    QJsonArray perTile;
+    for (int i = 0; i < src.cameras; ++i) {
+        const TileStats& t = run.tiles[size_t(i)];
+        delivered += t.delivered; drawn += t.drawn; unstamped += t.unstamped;
+        QJsonObject o;
+        o["tile"] = i;
+        o["delivered_fps"] = wallS > 0 ? t.delivered / wallS : 0.0;
+        o["drawn_fps"] = wallS > 0 ? t.drawn / wallS : 0.0;
+        perTile.append(o);
+    }
+
+    QJsonObject config;
+    config["cameras"] = src.cameras;
+    config["width"] = src.width;
+    config["height"] = src.height;
+    config["fps"] = src.fps;
+    config["bitrate_kbps"] = src.bitrateKbps;
+    config["gop_frames"] = src.gopFrames;
+    config["duration_sec"] = durationSec;
+    config["warmup_sec"] = warmupSec;
+    config["handoff"] = handoff == FrameHandoff::Sample ? "sample" : "pixmap";
+    config["platform"] = QGuiApplication::platformName();
+
+    QJsonObject result;
+    result["config"] = config;
+    result["measured_at"] = measuredAt;
+    result["glass_to_glass_latency"] = run.latency.toJson();
+    result["delivered_fps_per_tile"] = wallS > 0 ? delivered / wallS / src.cameras : 0.0;
+    result["drawn_fps_per_tile"] = wallS > 0 ? drawn / wallS / src.cameras : 0.0;
+    result["frames_not_drawn"] = double(delivered - qMin(delivered, drawn + unstamped));
+    result["frames_unstamped"] = double(unstamped);
+    result["cpp_allocs_per_frame"] = delivered ? double(allocs) / double(delivered) : 0.0;
+    result["cpu_pct_total"] = wallS > 0 ? cpuS / wallS * 100.0 : 0.0;
+    result["cpu_pct_per_tile"] = wallS > 0 ? cpuS / wallS * 100.0 / src.cameras : 0.0;
+    result["per_tile"] = perTile;
+
+    const QByteArray json = QJsonDocument(result).toJson(QJsonDocument::Indented);
+    fprintf(stdout, "%s", json.constData());
+    if (cli.isSet(jsonOpt)) {
+        QFile f(cli.value(jsonOpt));
+        if (f.open(QIODevice::WriteOnly | QIODevice::Truncate)) f.write(json);
+    }
+    return drawn > 0 ? 0 : 2;
+}
@@ -0,0 +1,271 @@
+// record_bench: how many cameras can this box record?
+//
+// Starts a synthetic RTSP server in a child process, points N ArchiveWorkers at
+// it (same pipeline and DbWriter as the app) and reports, after a warm-up:
+//   - sustained ingest MB/s (compressed bytes entering splitmuxsink, and bytes on disk)
+//   - segment-close latency (next fragment starts -> muxer finished the file)
+//   - RTP packets lost in the jitterbuffers, recorder errors
+//   - CPU per camera (this process only; encoders run in the child)
+//   - DB insert/finalize latency (queued call -> accepted by DbWriter; includes the
+//     group commit when that event fills a batch)
+// Results go to stdout as JSON (and --json <file>).
+//
+//   record_bench --cameras 16 --duration 120 --segment 10 --bitrate 4096
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QProcess>
+#include <QTcpSocket>
+#include <QTemporaryDir>
+#include <QThread>
+#include <QTimer>
+#include <QDebug>
+#include <gst/gst.h>
+#include <cstdio>
+#include <vector>
+
+#include "archiveworker.h"
+#include "db_writer.h"
+#include "bench_stats.h"
+#include "synthetic_rtsp_server.h"
+
+namespace {
+
+struct Totals {
+    QMutex mutex;
+    bench::LatencyStats segmentClose;
+    bench::LatencyStats dbInsert;
+    bench::LatencyStats dbFinalize;
+    QHash<QString, qint64> closeStartedMs;     // path -> clock when its successor opened
+    int segments = 0;
+    int errors = 0;
+};
+
+bool waitForPort(int port, int timeoutMs) {
+    QElapsedTimer t; t.start();
+    while (t.elapsed() < timeoutMs) {
+        QTcpSocket s;
+        s.connectToHost("127.0.0.1", quint16(port));
+        if (s.waitForConnected(200)) return true;
+        QThread::msleep(100);
+    }
+    return false;
+}
+
+qint64 bytesOnDisk(const QString& dir) {
+    qint64 total = 0;
+    QDirIterator it(dir, QStringList() << "*.mkv", QDir::Files);
+    while (it.hasNext()) { it.next(); total += it.fileInfo().size(); }
+    return total;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    QCoreApplication app(argc, argv);
+    QCommandLineParser cli;
+    cli.setApplicationDescription("CamVigil recording throughput benchmark");
+    cli.addHelpOption();
+    const QCommandLineOption serveOpt("serve", "Internal: run only the synthetic RTSP server.");
+    const QCommandLineOption camsOpt("cameras", "Number of cameras.", "n", "4");
+    const QCommandLineOption durOpt("duration", "Measured seconds (after warm-up).", "s", "60");
+    const QCommandLineOption warmOpt("warmup", "Warm-up seconds excluded from rates.", "s", "5");
+    const QCommandLineOption segOpt("segment", "Segment duration in seconds.", "s", "10");
+    const QCommandLineOption widthOpt("width", "Source width.", "px", "1920");
+    const QCommandLineOption heightOpt("height", "Source height.", "px", "1080");
+    const QCommandLineOption fpsOpt("fps", "Source frame rate.", "fps", "25");
+    const QCommandLineOption rateOpt("bitrate", "Source bitrate (kbps).", "kbps", "4096");
+    const QCommandLineOption gopOpt("gop", "Keyframe interval in frames (0 = 2 s).", "frames", "0");
+    const QCommandLineOption portOpt("port", "RTSP port.", "port", "8554");
+    const QCommandLineOption outOpt("out", "Archive directory (default: temporary, removed).", "dir");
+    const QCommandLineOption jsonOpt("json", "Also write the result JSON here.", "file");
+    cli.addOptions({ serveOpt, camsOpt, durOpt, warmOpt, segOpt, widthOpt, heightOpt,
+                     fpsOpt, rateOpt, gopOpt, portOpt, outOpt, jsonOpt });
+    cli.process(app);
+
+    SyntheticRtspServer::Config src;
+    src.cameras     = qMax(1, cli.value(camsOpt).toInt());
+    src.port        = cli.value(portOpt).toInt();
+    src.width       = cli.value(widthOpt).toInt();
+    src.height      = cli.value(heightOpt).toInt();
+    src.fps         = qMax(1, cli.value(fpsOpt).toInt());
+    src.bitrateKbps = cli.value(rateOpt).toInt();
+    src.gopFrames   = cli.value(gopOpt).toInt() > 0 ? cli.value(gopOpt).toInt() : src.fps * 2;
+
+    if (cli.isSet(serveOpt)) return SyntheticRtspServer::runServe(src);
+
+    gst_init(&argc, &argv);
+    const int warmupSec  = qMax(0, cli.value(warmOpt).toInt());
+    const int durationSec = qMax(1, cli.value(durOpt).toInt());
+    const int segmentSec = qMax(1, cli.value(segOpt).toInt());
+
+    // --- synthetic cameras (child process) ---
+    QProcess server;
+    server.setProcessChannelMode(QProcess::ForwardedErrorChannel);
+    server.start(QCoreApplication::applicationFilePath(), SyntheticRtspServer::serveArgs(src));
+    if (!server.waitForStarted(5000) || !waitForPort(src.port, 10000)) {
+        qCritical() << "[Bench] synthetic RTSP server did not come up";
+        return 1;
+    }
+
+    QTemporaryDir tmp;
+    const QString outDir = cli.isSet(outOpt) ? cli.value(outOpt) : tmp.path();
+    QDir().mkpath(outDir);
+
+    // --- DB exactly as ArchiveManager sets it up ---
+    QThread dbThread;
+    auto* db = new DbWriter();
+    db->moveToThread(&dbThread);
+    QObject::connect(&dbThread, &QThread::finished, db, &QObject::deleteLater);
+    dbThread.start();
+    QMetaObject::invokeMethod(db, "openAt", Qt::BlockingQueuedConnection,
+                              Q_ARG(QString, outDir + "/camvigil.sqlite"));
+    const QString sessionId = QString("bench-%1").arg(QDateTime::currentMSecsSinceEpoch());
+    for (int i = 0; i < src.cameras; ++i) {
+        const QString url = SyntheticRtspServer::urlFor(src.port, i);
+        QMetaObject::invokeMethod(db, [db, url, i]{ db->ensureCamera(url, url, QString("Bench %1").arg(i)); },
+                                  Qt::QueuedConnection);
+    }
+    QMetaObject::invokeMethod(db, [db, sessionId, outDir, segmentSec]{
+        db->beginSession(sessionId, outDir, segmentSec);
+    }, Qt::QueuedConnection);
+
+    // --- recorders ---
+    Totals totals;
+    QElapsedTimer clock; clock.start();
+    std::vector<ArchiveWorker*> workers;
+    const QDateTime masterStart = QDateTime::currentDateTime();
+    for (int i = 0; i < src.cameras; ++i) {
+        const QString url = SyntheticRtspServer::urlFor(src.port, i);
+        auto* w = new ArchiveWorker(url.toStdString(), i, outDir, segmentSec, masterStart);
+
+        // DB latency = queued call posted -> handled on the DB thread
+        QObject::connect(w, &ArchiveWorker::segmentOpened, &app,
+            [db, &totals, &clock, sessionId, url](int, const QString& path, qint64 startNs){
+                const qint64 posted = clock.nsecsElapsed();
+                QMetaObject::invokeMethod(db, [db, &totals, &clock, sessionId, url, path, startNs, posted]{
+                    db->addSegmentOpened(sessionId, url, path, startNs);
+                    QMutexLocker lk(&totals.mutex);
+                    totals.dbInsert.add((clock.nsecsElapsed() - posted) / 1e6);
+                }, Qt::QueuedConnection);
+            });
+        QObject::connect(w, &ArchiveWorker::segmentClosed, &app,
+            [db, &totals, &clock](int, const QString& path, qint64 endNs, qint64 durMs){
+                const qint64 posted = clock.nsecsElapsed();
+                {
+                    QMutexLocker lk(&totals.mutex);
+                    totals.closeStartedMs.insert(path, clock.elapsed());
+                }
+                QMetaObject::invokeMethod(db, [db, &totals, &clock, path, endNs, durMs, posted]{
+                    db->finalizeSegmentByPath(path, endNs, durMs);
+                    QMutexLocker lk(&totals.mutex);
+                    totals.dbFinalize.add((clock.nsecsElapsed() - posted) / 1e6);
+                }, Qt::QueuedConnection);
+            });
+        QObject::connect(w, &ArchiveWorker::segmentFileClosed, &app,
+            [&totals, &clock](int, const QString& path){
+                QMutexLocker lk(&totals.mutex);
+                ++totals.segments;
+                const auto it = totals.closeStartedMs.find(path);
+                if (it == totals.closeStartedMs.end()) return;
+                totals.segmentClose.add(double(clock.elapsed() - it.value()));
+                totals.closeStartedMs.erase(it);
+            });
+        QObject::connect(w, &ArchiveWorker::recordingError, &app, [&totals](const std::string& err){
+            qWarning() << "[Bench] recorder error:" << QString::fromStdString(err);
+            QMutexLocker lk(&totals.mutex);
+            ++totals.errors;
+        });
+        workers.push_back(w);
+        w->start();
+    }
+
+    // --- measurement window ---
+    quint64 bytes0 = 0, buffers0 = 0, lost0 = 0;
+    qint64 disk0 = 0;
+    double cpu0 = 0.0;
+    qint64 wall0 = 0;
+    QTimer::singleShot(warmupSec * 1000, &app, [&]{
+        for (auto* w : workers) {
+            const auto st = w->ingestStats();
+            bytes0 += st.bytes; buffers0 += st.buffers; lost0 += st.packetsLost;
+        }
+        disk0 = bytesOnDisk(outDir);
+        cpu0  = bench::cpuSeconds();
+        wall0 = clock.elapsed();
+        QTimer::singleShot(durationSec * 1000, &app, &QCoreApplication::quit);
+    });
+    app.exec();
+
+    quint64 bytes1 = 0, buffers1 = 0, lost1 = 0;
+    QJsonArray perCamera;
+    for (size_t i = 0; i < workers.size(); ++i) {
+        const auto st = workers[i]->ingestStats();
+        bytes1 += st.bytes; buffers1 += st.buffers; lost1 += st.packetsLost;
+        QJsonObject cam;
+        cam["camera"] = int(i);
+        cam["bytes"] = double(st.bytes);
+        cam["buffers"] = double(st.buffers);
+        cam["packets_lost"] = double(st.packetsLost);
+        perCamera.append(cam);
+    }
+    const double cpu1  = bench::cpuSeconds();
+    const double wallS = (clock.elapsed() - wall0) / 1000.0;
+
+    for (auto* w : workers) { w->stop(); w->wait(); delete w; }
+    workers.clear();
+    // drain queued DB work (and the last group commit) before reading the totals
+    QMetaObject::invokeMethod(db, [db]{ db->flushPending(); }, Qt::BlockingQueuedConnection);
+    const qint64 onDisk = bytesOnDisk(outDir);
+    dbThread.quit();
+    dbThread.wait();
+    server.terminate();
+    server.waitForFinished(3000);
+
+    QJsonObject result;
+    QJsonObject config;
+    config["cameras"] = src.cameras;
+    config["width"] = src.width;
+    config["height"] = src.height;
+    config["fps"] = src.fps;
+    config["bitrate_kbps"] = src.bitrateKbps;
+    config["gop_frames"] = src.gopFrames;
+    config["segment_sec"] = segmentSec;
+    config["duration_sec"] = durationSec;
+    config["warmup_sec"] = warmupSec;
+    result["config"] = config;
+    result["ingest_mb_per_s"] = wallS > 0 ? double(bytes1 - bytes0) / wallS / 1e6 : 0.0;
+    result["buffers_per_s"] = wallS > 0 ? double(buffers1 - buffers0) / wallS : 0.0;
+    result["bytes_on_disk"] = double(onDisk - disk0);   // measured window only
+    result["packets_lost"] = double(lost1 - lost0);
+    result["cpu_pct_total"] = wallS > 0 ? (cpu1 - cpu0) / wallS * 100.0 : 0.0;
+    result["cpu_pct_per_camera"] = wallS > 0 ? (cpu1 - cpu0) / wallS * 100.0 / src.cameras : 0.0;
+    {
+        QMutexLocker lk(&totals.mutex);
+        result["segments_closed"] = totals.segments;
+        result["recorder_errors"] = totals.errors;
+        result["segment_close_latency"] = totals.segmentClose.toJson();
+        result["db_insert_latency"] = totals.dbInsert.toJson();
+        result["db_finalize_latency"] = totals.dbFinalize.toJson();
+    }
+    result["per_camera"] = perCamera;
+
+    const QByteArray json = QJsonDocument(result).toJson(QJsonDocument::Indented);
+    fprintf(stdout, "%s", json.constData());
+    if (cli.isSet(jsonOpt)) {
+        QFile f(cli.value(jsonOpt));
+        if (f.open(QIODevice::WriteOnly | QIODevice::Truncate)) f.write(json);
+    }
+    return totals.errors > 0 ? 2 : 0;
+}
@@ -0,0 +1,28 @@
+# Recording throughput benchmark: N ArchiveWorkers against synthetic RTSP cameras.
+TARGET = record_bench
+include(../common/bench_common.pri)
+
+SOURCES += \
+    main.cpp \
+    $$CAMVIGIL_ROOT/archiveworker.cpp \
+    $$CAMVIGIL_ROOT/coverage_spans.cpp \
+    $$CAMVIGIL_ROOT/db_writer.cpp \
+    $$CAMVIGIL_ROOT/gst_bus_dispatcher.cpp \
+    $$CAMVIGIL_ROOT/metrics_registry.cpp \
+    $$CAMVIGIL_ROOT/segment_file_pool.cpp \
+    $$CAMVIGIL_ROOT/segment_sink.cpp \
+    $$CAMVIGIL_ROOT/storage_ledger.cpp \
+    $$CAMVIGIL_ROOT/streamworker.cpp
+
+HEADERS += \
+    $$CAMVIGIL_ROOT/archiveworker.h \
+    $$CAMVIGIL_ROOT/coverage_spans.h \
+    $$CAMVIGIL_ROOT/db_writer.h \
+    $$CAMVIGIL_ROOT/gst_bus_dispatcher.h \
+    $$CAMVIGIL_ROOT/keyframe_gate.h \
+    $$CAMVIGIL_ROOT/live_frame.h \
+    $$CAMVIGIL_ROOT/metrics_registry.h \
+    $$CAMVIGIL_ROOT/segment_file_pool.h \
+    $$CAMVIGIL_ROOT/segment_sink.h \
+    $$CAMVIGIL_ROOT/storage_ledger.h \
+    $$CAMVIGIL_ROOT/streamworker.h
@@ -74,6 +74,8 @@ void CameraManager::saveCameraNames() {
         camObj["url"] = QString::fromStdString(profile.url);
         camObj["suburl"] = QString::fromStdString(profile.suburl);
         camObj["name"] = QString::fromStdString(profile.displayName);
+        if (!profile.retention.isDefault())
+            camObj["retention"] = profile.retention.toJson();
         camerasArray.append(camObj);
     }
     json["cameras"] = camerasArray;
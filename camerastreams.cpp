@@ -76,6 +76,8 @@ void CameraStreams::loadFromJson() {
         std::string name = camObj["name"].toString().toStdString();
         if (existingUrls.find(url) == existingUrls.end()) {
             cameraUrls.emplace_back(url, suburl, name);
+            if (camObj["retention"].isObject())
+                cameraUrls.back().retention = RetentionPolicy::fromJson(camObj["retention"].toObject());
             existingUrls.insert(url);
             qDebug() << "Loaded Camera:" << QString::fromStdString(name)
                      << "->" << QString::fromStdString(url)
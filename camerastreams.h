@@ -11,13 +11,14 @@
 #include <QDir>
 #include <QDebug>
 #include <set>
+#include "retention_policy.h"
 
 class CamHWProfile {
 public:
     std::string url;       // Main URL for archiving (high quality)
     std::string suburl;    // Sub URL for streaming (low quality)
     std::string displayName;
-
+    RetentionPolicy retention;   // optional "retention" object in cameras.json
 
     CamHWProfile(const std::string& rtspUrl, const std::string& subUrl, const std::string& name = "")
         : url(rtspUrl), suburl(subUrl), displayName(name) {}
@@ -0,0 +1,83 @@
+#include "coverage_spans.h"
+#include <QDateTime>
+#include <QtEndian>
+#include <algorithm>
+
+CoverageSpans CoverageSpans::fromBlob(const QByteArray& blob) {
+    CoverageSpans c;
+    const int n = blob.size() / 8;
+    c.runs_.reserve(n);
+    const uchar* p = reinterpret_cast<const uchar*>(blob.constData());
+    for (int i = 0; i < n; ++i, p += 8) {
+        const Run r{ qFromLittleEndian<quint32>(p), qFromLittleEndian<quint32>(p + 4) };
+        if (r.end > r.start) c.runs_.push_back(r);
+    }
+    return c;
+}
+
+QByteArray CoverageSpans::toBlob() const {
+    QByteArray out(runs_.size() * 8, Qt::Uninitialized);
+    uchar* p = reinterpret_cast<uchar*>(out.data());
+    for (const Run& r : runs_) {
+        qToLittleEndian<quint32>(r.start, p);
+        qToLittleEndian<quint32>(r.end, p + 4);
+        p += 8;
+    }
+    return out;
+}
+
+void CoverageSpans::add(quint32 startSec, quint32 endSec) {
+    if (endSec <= startSec) return;
+    // First run that ends at or after startSec: everything before it is untouched.
+    auto first = std::lower_bound(runs_.begin(), runs_.end(), startSec,
+                                  [](const Run& r, quint32 s){ return r.end < s; });
+    auto last = first;
+    Run merged{ startSec, endSec };
+    while (last != runs_.end() && last->start <= endSec) {
+        merged.start = std::min(merged.start, last->start);
+        merged.end   = std::max(merged.end, last->end);
+        ++last;
+    }
+    if (first == last) {
+        runs_.insert(first, merged);
+    } else {
+        *first = merged;
+        runs_.erase(first + 1, last);
+    }
+}
+
+int CoverageSpans::runAt(quint32 sec) const {
+    auto it = std::upper_bound(runs_.cbegin(), runs_.cend(), sec,
+                               [](quint32 s, const Run& r){ return s < r.start; });
+    if (it == runs_.cbegin()) return -1;
+    --it;
+    return sec < it->end ? int(it - runs_.cbegin()) : -1;
+}
+
+quint32 CoverageSpans::coveredSeconds() const {
+    quint32 sum = 0;
+    for (const Run& r : runs_) sum += r.end - r.start;
+    return sum;
+}
+
+qint64 CoverageSpans::dayStartNs(const QDate& d) {
+    return QDateTime(d, QTime(0, 0), Qt::LocalTime).toMSecsSinceEpoch() * 1000000LL;
+}
+
+void CoverageSpans::forEachDay(qint64 startNs, qint64 endNs,
+                               const std::function<void(const QDate&, quint32, quint32)>& fn) {
+    if (endNs <= startNs) return;
+    QDate day = QDateTime::fromMSecsSinceEpoch(startNs / 1000000).date();
+    for (;;) {
+        const qint64 d0 = dayStartNs(day);
+        if (d0 >= endNs) break;
+        const qint64 d1 = dayStartNs(day.addDays(1));
+        const qint64 a = std::max(startNs, d0);
+        const qint64 b = std::min(endNs, d1);
+        if (b > a) {
+            fn(day, quint32((a - d0) / 1000000000LL),
+                    quint32((b - d0 + 999999999LL) / 1000000000LL));
+        }
+        day = day.addDays(1);
+    }
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <QByteArray>
+#include <QDate>
+#include <QVector>
+#include <functional>
+
+/**
+ * coverage_spans
+ * --------------
+ * Recorded time of one camera on one local day: sorted, disjoint [start, end)
+ * runs in whole seconds from local midnight (1 s resolution).
+ * - persisted per (camera, day) in camera_coverage as a BLOB of little-endian
+ *   quint32 pairs; a continuously recorded day is a single 8-byte run
+ * - add() merges one finalized segment in place (touching runs coalesce)
+ * - runAt() is a binary search, so hit tests do not walk the day
+ */
+class CoverageSpans {
+public:
+    struct Run { quint32 start; quint32 end; };
+
+    static CoverageSpans fromBlob(const QByteArray& blob);
+    QByteArray toBlob() const;
+
+    void add(quint32 startSec, quint32 endSec);
+    bool isEmpty() const { return runs_.isEmpty(); }
+    const QVector<Run>& runs() const { return runs_; }
+    int runAt(quint32 sec) const;          // index of the run containing sec, or -1
+    quint32 coveredSeconds() const;
+
+    // Local midnight of d, in UTC epoch ns (23 h / 25 h days on DST switches).
+    static qint64 dayStartNs(const QDate& d);
+    // Splits [startNs, endNs) at local midnights; fn gets each day and its
+    // second range (start floored, end rounded up).
+    static void forEachDay(qint64 startNs, qint64 endNs,
+                           const std::function<void(const QDate&, quint32, quint32)>& fn);
+
+private:
+    QVector<Run> runs_;
+};
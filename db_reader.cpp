@@ -6,6 +6,57 @@
 #include <QDateTime>
 #include <QtDebug>
 
+// Prepared once per connection in openAt().
+static const char* const kCamerasSql = R"SQL(
+        SELECT c.id, c.name
+        FROM cameras c
+        WHERE EXISTS (
+          SELECT 1 FROM segments s
+          WHERE s.camera_id=c.id AND s.status IN (0,1)
+        )
+        ORDER BY c.name
+    )SQL";
+
+// camera_days is maintained by DbWriter: one PK range read, no per-row strftime
+static const char* const kDaysSql = R"SQL(
+        SELECT day FROM camera_days
+        WHERE camera_id=:cid AND segments>0
+        ORDER BY day
+    )SQL";
+
+// Overlap with [start_ns, end_ns) as one range scan on idx_segments_camera_end.
+// The upper bound on end_utc_ns relies on segments being shorter than a day.
+// Open rows carry end_utc_ns == start_utc_ns until finalized (no "now()" fallback).
+static const char* const kSegmentsSql = R"SQL(
+      SELECT s.file_path, s.start_utc_ns, s.end_utc_ns, s.duration_ms
+      FROM segments s
+      WHERE s.camera_id = :cid
+        AND s.end_utc_ns > :start_ns
+        AND s.end_utc_ns < :end_ns + 86400000000000
+        AND s.start_utc_ns < :end_ns
+        AND s.status IN (0,1)
+      ORDER BY s.start_utc_ns
+    )SQL";
+
+// One PK lookup; spans are CoverageSpans runs in seconds from local midnight.
+static const char* const kCoverageSql = R"SQL(
+        SELECT spans FROM camera_coverage
+        WHERE camera_id=:cid AND day=:day
+    )SQL";
+
+static const char* const kRecentSql = R"SQL(
+      SELECT s.file_path,
+             COALESCE(c.name, s.camera_url) AS camera_name,
+             s.start_utc_ns,
+             s.end_utc_ns,
+             COALESCE(s.duration_ms, 0)
+      FROM segments s
+      LEFT JOIN cameras c ON c.id = s.camera_id
+      WHERE s.status IN (0,1)
+      ORDER BY s.start_utc_ns DESC
+      LIMIT :lim
+    )SQL";
+
 DbReader::DbReader(QObject* parent) : QObject(parent) {
     // Ensure queued connections work for custom types
     qRegisterMetaType<RecentSegment>("RecentSegment");
@@ -14,6 +65,7 @@ DbReader::DbReader(QObject* parent) : QObject(parent) {
 
 DbReader::~DbReader() {
     // ensure clean teardown even if window is closed externally
+    releaseStatements_();
     if (db_.isValid()) {
         if (db_.isOpen()) db_.close();
         db_ = QSqlDatabase();
@@ -24,6 +76,7 @@ DbReader::~DbReader() {
 void DbReader::shutdown() {
     // Must be invoked on the DB thread (use BlockingQueuedConnection)
     qInfo() << "[DB] shutdown() begin";
+    releaseStatements_();
     if (db_.isValid()) {
         if (db_.isOpen()) db_.close();
         db_ = QSqlDatabase();
@@ -42,6 +95,7 @@ void DbReader::openAt(const QString& dbPath) {
                         .arg(reinterpret_cast<quintptr>(this));
         db_ = QSqlDatabase::addDatabase("QSQLITE", connName_);
     } else if (db_.isOpen()) {
+        releaseStatements_();
         db_.close();
     }
 
@@ -51,46 +105,65 @@ void DbReader::openAt(const QString& dbPath) {
         "QSQLITE_ENABLE_SHARED_CACHE=1;"
         "QSQLITE_BUSY_TIMEOUT=5000"
     );
-    const bool ok = db_.open();
+    bool ok = db_.open();
+    QString err = ok ? QString() : db_.lastError().text();
+    if (ok && !prepareStatements_()) { ok = false; err = "failed to prepare playback queries"; }
     qInfo() << "[DB] RO open:" << QFileInfo(db_.databaseName()).absoluteFilePath();
-    emit opened(ok, ok ? QString() : db_.lastError().text());
+    emit opened(ok, err);
+}
+
+bool DbReader::prepareStatements_() {
+    const struct { QSqlQuery* q; const char* sql; } stmts[] = {
+        { &stCameras_, kCamerasSql }, { &stDays_, kDaysSql },
+        { &stSegments_, kSegmentsSql }, { &stRecent_, kRecentSql },
+        { &stCoverage_, kCoverageSql },
+    };
+    for (const auto& s : stmts) {
+        *s.q = QSqlQuery(db_);
+        s.q->setForwardOnly(true);
+        if (!s.q->prepare(QString::fromLatin1(s.sql))) {
+            qWarning() << "[DB] RO prepare failed:" << s.q->lastError().text();
+            return false;
+        }
+    }
+    return true;
+}
+
+// Queries must go before the connection is closed or removed.
+void DbReader::releaseStatements_() {
+    stCameras_ = stDays_ = stSegments_ = stRecent_ = stCoverage_ = QSqlQuery();
 }
 
 void DbReader::listCameras() {
     QVector<QPair<int,QString>> out;
-    QSqlQuery q(db_);
-    q.prepare(R"SQL(
-        SELECT c.id, c.name
-        FROM cameras c
-        WHERE EXISTS (
-          SELECT 1 FROM segments s
-          WHERE s.status IN (0,1)
-            AND (s.camera_id=c.id OR s.camera_url=c.main_url)
-        )
-        ORDER BY c.name
-    )SQL");
+    QSqlQuery& q = stCameras_;
     if (!q.exec()) { emit error(q.lastError().text()); return; }
     while (q.next()) out.push_back({ q.value(0).toInt(), q.value(1).toString() });
+    q.finish();
     emit camerasReady(out);
 }
 
 void DbReader::listDays(int cameraId) {
     QStringList days;
-    QSqlQuery q(db_);
-    q.prepare(R"SQL(
-        SELECT DISTINCT strftime('%Y-%m-%d',
-                                 datetime(start_utc_ns/1000000000,'unixepoch','localtime'))
-        FROM segments
-        WHERE status IN (0,1)
-          AND (camera_id=:cid OR camera_url=(SELECT main_url FROM cameras WHERE id=:cid))
-        ORDER BY 1
-    )SQL");
+    QSqlQuery& q = stDays_;
     q.bindValue(":cid", cameraId);
     if (!q.exec()) { emit error(q.lastError().text()); return; }
     while (q.next()) days << q.value(0).toString();
+    q.finish();
     emit daysReady(cameraId, days);
 }
 
+void DbReader::listCoverage(int cameraId, const QString& ymd) {
+    QByteArray spans;
+    QSqlQuery& q = stCoverage_;
+    q.bindValue(":cid", cameraId);
+    q.bindValue(":day", ymd);
+    if (!q.exec()) { emit error(q.lastError().text()); return; }
+    if (q.next()) spans = q.value(0).toByteArray();
+    q.finish();
+    emit coverageReady(cameraId, ymd, spans);
+}
+
 void DbReader::listSegments(int cameraId, const QString& ymd) {
     // compute local-day window in UTC epoch nanoseconds
     const QDate d = QDate::fromString(ymd, "yyyy-MM-dd");
@@ -100,62 +173,7 @@ void DbReader::listSegments(int cameraId, const QString& ymd) {
     const qint64 end_ns   = d1.toSecsSinceEpoch() * 1000000000LL;
 
     QVector<SegmentInfo> segs;
-    QSqlQuery q(db_);
-    q.setForwardOnly(true);
-
-    // NOTE: no "now()" fallback — open-ended rows collapse to start_utc_ns
-    q.prepare(R"SQL(
-      SELECT path, start_utc_ns, eff_end_ns, duration_ms FROM (
-        -- branch 1: rows with camera_id filled (uses idx_segments_camera_time)
-        SELECT
-          s.file_path AS path,
-          s.start_utc_ns,
-          CASE
-            WHEN s.end_utc_ns IS NOT NULL AND s.end_utc_ns > 0 THEN s.end_utc_ns
-            WHEN COALESCE(s.duration_ms,0) > 0 THEN s.start_utc_ns + s.duration_ms*1000000
-            ELSE s.start_utc_ns
-          END AS eff_end_ns,
-          s.duration_ms
-        FROM segments s
-        WHERE s.status IN (0,1)
-          AND s.camera_id = :cid
-          AND s.start_utc_ns < :end_ns
-          AND (
-                CASE
-                  WHEN s.end_utc_ns IS NOT NULL AND s.end_utc_ns > 0 THEN s.end_utc_ns
-                  WHEN COALESCE(s.duration_ms,0) > 0 THEN s.start_utc_ns + s.duration_ms*1000000
-                  ELSE s.start_utc_ns
-                END
-              ) > :start_ns
-
-        UNION ALL
-
-        -- branch 2: legacy rows matched by URL
-        SELECT
-          s.file_path AS path,
-          s.start_utc_ns,
-          CASE
-            WHEN s.end_utc_ns IS NOT NULL AND s.end_utc_ns > 0 THEN s.end_utc_ns
-            WHEN COALESCE(s.duration_ms,0) > 0 THEN s.start_utc_ns + s.duration_ms*1000000
-            ELSE s.start_utc_ns
-          END AS eff_end_ns,
-          s.duration_ms
-        FROM segments s
-        WHERE s.status IN (0,1)
-          AND s.camera_id IS NULL
-          AND s.camera_url = (SELECT main_url FROM cameras WHERE id=:cid)
-          AND s.start_utc_ns < :end_ns
-          AND (
-                CASE
-                  WHEN s.end_utc_ns IS NOT NULL AND s.end_utc_ns > 0 THEN s.end_utc_ns
-                  WHEN COALESCE(s.duration_ms,0) > 0 THEN s.start_utc_ns + s.duration_ms*1000000
-                  ELSE s.start_utc_ns
-                END
-              ) > :start_ns
-      )
-      ORDER BY start_utc_ns
-    )SQL");
-
+    QSqlQuery& q = stSegments_;
     q.bindValue(":cid", cameraId);
     q.bindValue(":start_ns", start_ns);
     q.bindValue(":end_ns", end_ns);
@@ -176,32 +194,13 @@ void DbReader::listSegments(int cameraId, const QString& ymd) {
         s.duration_ms = q.value(3).toLongLong();
         segs.push_back(s);
     }
+    q.finish();
     emit segmentsReady(cameraId, segs);
 }
 void DbReader::listRecentSegments(int limit) {
     QVector<RecentSegment> out;
-    QSqlQuery q(db_);
-    q.setForwardOnly(true);
-
-    // Use end_utc_ns if set, else derive from duration_ms, else fall back to start_utc_ns
-    q.prepare(R"SQL(
-      SELECT s.file_path,
-             COALESCE(c.name, s.camera_url) AS camera_name,
-             s.start_utc_ns,
-             CASE
-               WHEN s.end_utc_ns IS NOT NULL AND s.end_utc_ns > 0 THEN s.end_utc_ns
-               WHEN COALESCE(s.duration_ms,0) > 0 THEN s.start_utc_ns + s.duration_ms*1000000
-               ELSE s.start_utc_ns
-             END AS eff_end_ns,
-             COALESCE(s.duration_ms, 0)
-      FROM segments s
-      LEFT JOIN cameras c ON c.id = s.camera_id
-      WHERE s.status IN (0,1)
-      ORDER BY s.start_utc_ns DESC
-      LIMIT :lim
-    )SQL");
+    QSqlQuery& q = stRecent_;
     q.bindValue(":lim", limit);
-
     if (!q.exec()) { emit error(q.lastError().text()); return; }
 
     while (q.next()) {
@@ -213,5 +212,6 @@ void DbReader::listRecentSegments(int limit) {
         r.duration_ms = q.value(4).toLongLong();
         out.push_back(r);
     }
+    q.finish();
     emit recentSegmentsReady(out);
 }
@@ -1,6 +1,7 @@
 #pragma once
 #include <QObject>
 #include <QSqlDatabase>
+#include <QSqlQuery>
 #include <QVector>
 #include <QPair>
 #include <QStringList>
@@ -21,7 +22,7 @@ struct RecentSegment {
     QString path;
     QString camera_name;
     qint64  start_ns;
-    qint64  end_ns;       // 0 if open-ended
+    qint64  end_ns;       // == start_ns while the segment is open
     qint64  duration_ms;  // may be 0 if open-ended
 };
 Q_DECLARE_METATYPE(RecentSegment)
@@ -36,6 +37,7 @@ public slots:
     void listCameras();                                 // id + name, only with recordings
     void listDays(int cameraId);                        // distinct YYYY-MM-DD with data
     void listSegments(int cameraId, const QString& ymd);// segments overlapping that day
+    void listCoverage(int cameraId, const QString& ymd);// recorded spans of that day (camera_coverage)
     void shutdown();
     void listRecentSegments(int limit = 500);
 signals:
@@ -43,9 +45,19 @@ signals:
     void camerasReady(CamList cams);
     void daysReady(int cameraId, QStringList ymdList);
     void segmentsReady(int cameraId, SegmentList segs);
+    void coverageReady(int cameraId, QString ymd, QByteArray spans);   // empty = nothing recorded
     void error(QString err);
     void recentSegmentsReady(QVector<RecentSegment> segs);
 private:
+    bool prepareStatements_();
+    void releaseStatements_();
+
     QSqlDatabase db_;
     QString      connName_; // for QSqlDatabase::removeDatabase
+    // Prepared once per open; released before the connection is closed
+    QSqlQuery    stCameras_;
+    QSqlQuery    stDays_;
+    QSqlQuery    stSegments_;
+    QSqlQuery    stRecent_;
+    QSqlQuery    stCoverage_;
 };
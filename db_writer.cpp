@@ -3,12 +3,39 @@
 #include <QSqlError>
 #include <QSqlRecord>
 #include <QVariant>
+#include <QStringList>
+#include <QFile>
 #include <QFileInfo>
 #include <QDir>
+#include <QDateTime>
 #include <QDebug>
+#include <QTimer>
+#include <sys/stat.h>
+#include "coverage_spans.h"
+#include "metrics_registry.h"
 
-DbWriter::DbWriter(QObject* parent) : QObject(parent) {}
+// camvigil_db_statement_seconds{op=...}; one series per DbWriter call site.
+static MetricHistogram& statementSeconds(const char* op) {
+    return MetricsRegistry::instance().histogram("camvigil_db_statement_seconds",
+                                                 "Wall time of DbWriter statements",
+                                                 MetricsRegistry::label("op", QString::fromLatin1(op)));
+}
+
+// camera_days key: local calendar day of a segment start (matches the readers' 'localtime')
+static QString localDay(qint64 startUtcNs) {
+    return StorageLedger::dayOf(startUtcNs).toString("yyyy-MM-dd");
+}
+
+DbWriter::DbWriter(QObject* parent) : QObject(parent) {
+    bool ok = false;
+    const int ms = qEnvironmentVariable("CAMVIGIL_DB_COMMIT_MS").toInt(&ok);
+    if (ok && ms >= 0) commitMs_ = ms;
+    const int ops = qEnvironmentVariable("CAMVIGIL_DB_COMMIT_OPS").toInt(&ok);
+    if (ok && ops >= 1) commitOps_ = ops;
+}
 DbWriter::~DbWriter() {
+    flushPending();
+    releaseStatements_();
     if (db_.isOpen()) db_.close();
 }
 
@@ -22,7 +49,70 @@ bool DbWriter::openAt(const QString& dbFile) {
         exec("PRAGMA synchronous=NORMAL;");
         exec("PRAGMA foreign_keys=ON;");
         if (!ensureSchema()) return false;
-        return migrateSchema_();
+        if (!migrateSchema_()) return false;
+        return prepareStatements_();
+}
+
+// Hot statements are parsed once per connection and re-bound on every call.
+static bool prepareOn(QSqlDatabase& db, QSqlQuery& q, const char* sql) {
+    q = QSqlQuery(db);
+    if (q.prepare(QString::fromLatin1(sql))) return true;
+    qWarning() << "[DB] prepare failed:" << q.lastError().text() << " sql:" << sql;
+    return false;
+}
+
+// Queries must go before the connection is closed or removed.
+void DbWriter::releaseStatements_() {
+    for (QSqlQuery* q : { &stUpsertCamera_, &stCameraId_, &stInsertSegment_, &stSegmentByPath_,
+                          &stFinalizeSegment_, &stPurgeCam_, &stPurgeAll_, &stPurgeLegacy_,
+                          &stMarkPinned_, &stBumpDay_, &stDropDay_, &stPruneDays_,
+                          &stCoverageGet_, &stCoveragePut_, &stCoverageDel_, &stCoverageRows_ })
+        *q = QSqlQuery();
+}
+
+bool DbWriter::prepareStatements_() {
+    const bool ok =
+        prepareOn(db_, stUpsertCamera_,
+                  "INSERT INTO cameras(name, main_url, sub_url) VALUES(?,?,?) "
+                  "ON CONFLICT(main_url) DO UPDATE SET name=excluded.name, sub_url=excluded.sub_url;") &&
+        prepareOn(db_, stCameraId_, "SELECT id FROM cameras WHERE main_url=?;") &&
+        prepareOn(db_, stInsertSegment_,
+                  "INSERT OR IGNORE INTO segments(session_id,camera_id,camera_url,file_path,start_utc_ns,end_utc_ns,status)"
+                  " VALUES(?,?,?,?,?,?,0);") &&
+        prepareOn(db_, stSegmentByPath_, "SELECT camera_id, start_utc_ns, status FROM segments WHERE file_path=?;") &&
+        prepareOn(db_, stFinalizeSegment_,
+                  "UPDATE segments SET end_utc_ns=?, duration_ms=?, size_bytes=?, status=1 WHERE file_path=?;") &&
+        prepareOn(db_, stPurgeCam_,
+                  "SELECT id, file_path FROM segments"
+                  " WHERE status=1 AND pinned=0 AND camera_id=? AND start_utc_ns<?"
+                  " ORDER BY start_utc_ns ASC LIMIT ?;") &&
+        prepareOn(db_, stPurgeAll_,
+                  "SELECT id, file_path FROM segments"
+                  " WHERE status=1 AND pinned=0 AND start_utc_ns<?"
+                  " ORDER BY start_utc_ns ASC LIMIT ?;") &&
+        prepareOn(db_, stPurgeLegacy_,
+                  "SELECT id, file_path FROM segments"
+                  " WHERE status=1 AND pinned=0 AND camera_id IS NULL AND start_utc_ns<?"
+                  " ORDER BY start_utc_ns ASC LIMIT ?;") &&
+        prepareOn(db_, stMarkPinned_, "UPDATE segments SET pinned=? WHERE file_path=?;") &&
+        prepareOn(db_, stBumpDay_,
+                  "INSERT INTO camera_days(camera_id, day, segments) VALUES(?,?,1)"
+                  " ON CONFLICT(camera_id, day) DO UPDATE SET segments=segments+1;") &&
+        prepareOn(db_, stDropDay_, "UPDATE camera_days SET segments=segments-? WHERE camera_id=? AND day=?;") &&
+        prepareOn(db_, stPruneDays_, "DELETE FROM camera_days WHERE segments<=0;") &&
+        prepareOn(db_, stCoverageGet_, "SELECT spans FROM camera_coverage WHERE camera_id=? AND day=?;") &&
+        prepareOn(db_, stCoveragePut_, "INSERT OR REPLACE INTO camera_coverage(camera_id, day, spans) VALUES(?,?,?);") &&
+        prepareOn(db_, stCoverageDel_, "DELETE FROM camera_coverage WHERE camera_id=? AND day=?;") &&
+        prepareOn(db_, stCoverageRows_,
+                  "SELECT start_utc_ns, end_utc_ns FROM segments"
+                  " WHERE camera_id=? AND end_utc_ns>? AND end_utc_ns<? AND start_utc_ns<? AND status=1;");
+    if (!ok) return false;
+
+    cameraIds_.clear();
+    QSqlQuery q(db_);
+    if (!q.exec("SELECT main_url, id FROM cameras;")) { qWarning() << "[DB] camera map:" << q.lastError().text(); return false; }
+    while (q.next()) cameraIds_.insert(q.value(0).toString(), q.value(1).toInt());
+    return true;
 }
 
 bool DbWriter::exec(const QString& sql) {
@@ -52,20 +142,18 @@ bool DbWriter::ensureSchema() {
              " FOREIGN KEY(camera_id) REFERENCES cameras(id) ON DELETE SET NULL );") &&
         exec("CREATE INDEX IF NOT EXISTS idx_segments_camera_time ON segments(camera_id,start_utc_ns);") &&
         exec("CREATE INDEX IF NOT EXISTS idx_segments_path ON segments(file_path);") &&
-        exec("CREATE INDEX IF NOT EXISTS idx_segments_camera_url_time ON segments(camera_url, start_utc_ns);") &&
         exec("CREATE INDEX IF NOT EXISTS idx_segments_start_desc ON segments(start_utc_ns DESC);") &&
         exec("CREATE INDEX IF NOT EXISTS idx_segments_status_time ON segments(status, start_utc_ns);");
 }
 
 
 void DbWriter::ensureCamera(const QString& mainUrl, const QString& subUrl, const QString& name) {
-    QSqlQuery q(db_);
-    q.prepare("INSERT INTO cameras(name, main_url, sub_url) VALUES(?,?,?) "
-              "ON CONFLICT(main_url) DO UPDATE SET name=excluded.name, sub_url=excluded.sub_url;");
-    q.addBindValue(name);
-    q.addBindValue(mainUrl);
-    q.addBindValue(subUrl);
-    if (!q.exec()) qWarning() << "[DB] ensureCamera:" << q.lastError().text();
+    stUpsertCamera_.bindValue(0, name);
+    stUpsertCamera_.bindValue(1, mainUrl);
+    stUpsertCamera_.bindValue(2, subUrl);
+    if (!stUpsertCamera_.exec()) { qWarning() << "[DB] ensureCamera:" << stUpsertCamera_.lastError().text(); return; }
+    cameraIds_.remove(mainUrl);
+    cameraIdFor_(mainUrl);   // refresh the URL -> id map
 }
 
 void DbWriter::beginSession(const QString& sessionId, const QString& archiveDir, int segmentSec) {
@@ -78,37 +166,182 @@ void DbWriter::beginSession(const QString& sessionId, const QString& archiveDir,
     if (!q.exec()) qWarning() << "[DB] beginSession:" << q.lastError().text();
 }
 
-static int cameraIdForUrl(QSqlDatabase& db, const QString& url) {
-    QSqlQuery q(db);
-    q.prepare("SELECT id FROM cameras WHERE main_url=?;");
-    q.addBindValue(url);
-    if (q.exec() && q.next()) return q.value(0).toInt();
-    return 0;
+int DbWriter::cameraIdFor_(const QString& url) {
+    const auto it = cameraIds_.constFind(url);
+    if (it != cameraIds_.constEnd()) return it.value();
+    int id = 0;
+    stCameraId_.bindValue(0, url);
+    if (stCameraId_.exec() && stCameraId_.next()) id = stCameraId_.value(0).toInt();
+    stCameraId_.finish();
+    if (id <= 0 && !url.isEmpty()) {
+        // Never write a segment without a camera row; the name is fixed up by ensureCamera
+        QSqlQuery q(db_);
+        q.prepare("INSERT OR IGNORE INTO cameras(name, main_url) VALUES(?, ?);");
+        q.addBindValue(url);
+        q.addBindValue(url);
+        if (q.exec()) id = q.lastInsertId().toInt();
+    }
+    if (id > 0) cameraIds_.insert(url, id);
+    return id;
 }
 
+// Segment open/close events are queued and committed together: one transaction
+// per CAMVIGIL_DB_COMMIT_MS (250) or CAMVIGIL_DB_COMMIT_OPS (64) events,
+// whichever comes first. Ops keep their arrival order inside the transaction.
 void DbWriter::addSegmentOpened(const QString& sessionId, const QString& cameraUrl,
                                 const QString& filePath, qint64 startUtcNs) {
-    const int camId = cameraIdForUrl(db_, cameraUrl);
-    QSqlQuery q(db_);
-    q.prepare("INSERT OR IGNORE INTO segments(session_id,camera_id,camera_url,file_path,start_utc_ns,status)"
-              " VALUES(?,?,?,?,?,0);");
-    q.addBindValue(sessionId);
-    q.addBindValue(camId);
-    q.addBindValue(cameraUrl);
-    q.addBindValue(filePath);
-    q.addBindValue(startUtcNs);
-    if (!q.exec()) qWarning() << "[DB] addSegmentOpened:" << q.lastError().text();
+    enqueue_({ PendingOp::Open, sessionId, cameraUrl, filePath, startUtcNs, 0 });
 }
 
 void DbWriter::finalizeSegmentByPath(const QString& filePath, qint64 endUtcNs, qint64 durationMs) {
-    const qint64 size = QFileInfo(filePath).exists() ? QFileInfo(filePath).size() : 0;
-    QSqlQuery q(db_);
-    q.prepare("UPDATE segments SET end_utc_ns=?, duration_ms=?, size_bytes=?, status=1 WHERE file_path=?;");
-    q.addBindValue(endUtcNs);
-    q.addBindValue(durationMs);
-    q.addBindValue(size);
-    q.addBindValue(filePath);
-    if (!q.exec()) qWarning() << "[DB] finalizeSegment:" << q.lastError().text();
+    enqueue_({ PendingOp::Finalize, QString(), QString(), filePath, endUtcNs, durationMs });
+}
+
+void DbWriter::enqueue_(PendingOp&& op) {
+    pending_.push_back(std::move(op));
+    if (pending_.size() >= commitOps_) { flushPending(); return; }
+    if (!flushTimer_) {
+        flushTimer_ = new QTimer(this);
+        flushTimer_->setSingleShot(true);
+        connect(flushTimer_, &QTimer::timeout, this, &DbWriter::flushPending);
+    }
+    if (!flushTimer_->isActive()) flushTimer_->start(commitMs_);
+}
+
+void DbWriter::flushPending() {
+    if (flushTimer_) flushTimer_->stop();
+    if (pending_.isEmpty() || !db_.isOpen()) return;
+    static MetricHistogram& h = statementSeconds("group_commit");
+    MetricTimer t(h);
+
+    QVector<PendingOp> ops;
+    ops.swap(pending_);
+    QVector<LedgerAdd> adds;
+    const bool batched = db_.transaction();
+    if (!batched) qWarning() << "[DB] group commit: begin failed, writing" << ops.size() << "ops one by one:" << db_.lastError().text();
+    for (const auto& op : qAsConst(ops)) {
+        if (op.kind == PendingOp::Open) writeOpened_(op);
+        else writeFinalized_(op, adds);
+    }
+    if (batched && !db_.commit()) {
+        // Nothing landed; replay in autocommit so no segment row is lost.
+        qWarning() << "[DB] group commit failed:" << db_.lastError().text() << "- replaying" << ops.size() << "ops";
+        db_.rollback();
+        adds.clear();
+        for (const auto& op : qAsConst(ops)) {
+            if (op.kind == PendingOp::Open) writeOpened_(op);
+            else writeFinalized_(op, adds);
+        }
+    }
+    if (ledger_) for (const auto& a : qAsConst(adds)) ledger_->addSegment(a.cameraId, a.startNs, a.bytes);
+}
+
+bool DbWriter::writeOpened_(const PendingOp& op) {
+    static MetricHistogram& h = statementSeconds("segment_open");
+    MetricTimer t(h);
+    const int camId = cameraIdFor_(op.cameraUrl);
+    QSqlQuery& q = stInsertSegment_;
+    q.bindValue(0, op.sessionId);
+    q.bindValue(1, camId);
+    q.bindValue(2, op.cameraUrl);
+    q.bindValue(3, op.filePath);
+    q.bindValue(4, op.utcNs);
+    q.bindValue(5, op.utcNs);    // open rows end where they start until finalized
+    if (!q.exec()) { qWarning() << "[DB] addSegmentOpened:" << q.lastError().text(); return false; }
+    if (q.numRowsAffected() > 0 && camId > 0) {
+        stBumpDay_.bindValue(0, camId);
+        stBumpDay_.bindValue(1, localDay(op.utcNs));
+        if (!stBumpDay_.exec()) qWarning() << "[DB] camera_days:" << stBumpDay_.lastError().text();
+    }
+    return true;
+}
+
+// Caller holds the transaction the rows were deleted in.
+bool DbWriter::dropDays_(const QVector<QPair<int, qint64>>& cameraStarts) {
+    QHash<QPair<int, QString>, int> counts;
+    for (const auto& cs : cameraStarts) ++counts[{ cs.first, localDay(cs.second) }];
+    for (auto it = counts.cbegin(); it != counts.cend(); ++it) {
+        stDropDay_.bindValue(0, it.value());
+        stDropDay_.bindValue(1, it.key().first);
+        stDropDay_.bindValue(2, it.key().second);
+        if (!stDropDay_.exec()) { qWarning() << "[DB] camera_days:" << stDropDay_.lastError().text(); return false; }
+    }
+    if (!stPruneDays_.exec()) { qWarning() << "[DB] camera_days:" << stPruneDays_.lastError().text(); return false; }
+    return true;
+}
+
+bool DbWriter::writeFinalized_(const PendingOp& op, QVector<LedgerAdd>& adds) {
+    static MetricHistogram& h = statementSeconds("segment_finalize");
+    MetricTimer t(h);
+    const qint64 size = QFileInfo(op.filePath).exists() ? QFileInfo(op.filePath).size() : 0;
+    int camId = 0; qint64 startNs = 0; bool wasOpen = false;
+    {
+        QSqlQuery& s = stSegmentByPath_;
+        s.bindValue(0, op.filePath);
+        if (s.exec() && s.next()) {
+            camId   = s.value(0).toInt();
+            startNs = s.value(1).toLongLong();
+            wasOpen = s.value(2).toInt() == 0;
+        }
+        s.finish();
+    }
+    QSqlQuery& q = stFinalizeSegment_;
+    q.bindValue(0, op.utcNs);
+    q.bindValue(1, op.durationMs);
+    q.bindValue(2, size);
+    q.bindValue(3, op.filePath);
+    if (!q.exec()) { qWarning() << "[DB] finalizeSegment:" << q.lastError().text(); return false; }
+    if (wasOpen) addCoverage_(camId, startNs, op.utcNs);
+    if (ledger_ && wasOpen) adds.push_back({ camId, startNs, size });
+    return true;
+}
+
+// Merges one finalized segment into its day(s) of camera_coverage.
+void DbWriter::addCoverage_(int cameraId, qint64 startNs, qint64 endNs) {
+    if (cameraId <= 0) return;
+    CoverageSpans::forEachDay(startNs, endNs, [&](const QDate& day, quint32 a, quint32 b){
+        const QString key = day.toString("yyyy-MM-dd");
+        stCoverageGet_.bindValue(0, cameraId);
+        stCoverageGet_.bindValue(1, key);
+        QByteArray blob;
+        if (stCoverageGet_.exec() && stCoverageGet_.next()) blob = stCoverageGet_.value(0).toByteArray();
+        stCoverageGet_.finish();
+        CoverageSpans spans = CoverageSpans::fromBlob(blob);
+        spans.add(a, b);
+        storeCoverage_(cameraId, key, spans);
+    });
+}
+
+void DbWriter::storeCoverage_(int cameraId, const QString& day, const CoverageSpans& spans) {
+    QSqlQuery& q = spans.isEmpty() ? stCoverageDel_ : stCoveragePut_;
+    q.bindValue(0, cameraId);
+    q.bindValue(1, day);
+    if (!spans.isEmpty()) q.bindValue(2, spans.toBlob());
+    if (!q.exec()) qWarning() << "[DB] camera_coverage:" << q.lastError().text();
+}
+
+// After deletes: rebuild the touched days from the finalized rows that remain.
+bool DbWriter::rebuildCoverage_(const QSet<QPair<int, QString>>& cameraDays) {
+    for (const auto& cd : cameraDays) {
+        const QDate day = QDate::fromString(cd.second, "yyyy-MM-dd");
+        const qint64 d0 = CoverageSpans::dayStartNs(day);
+        const qint64 d1 = CoverageSpans::dayStartNs(day.addDays(1));
+        QSqlQuery& q = stCoverageRows_;
+        q.bindValue(0, cd.first);
+        q.bindValue(1, d0);
+        q.bindValue(2, d1 + 86400LL * 1000000000LL);
+        q.bindValue(3, d1);
+        if (!q.exec()) { qWarning() << "[DB] camera_coverage:" << q.lastError().text(); return false; }
+        CoverageSpans spans;
+        while (q.next()) {
+            const qint64 a = qMax(q.value(0).toLongLong(), d0);
+            const qint64 b = qMin(q.value(1).toLongLong(), d1);
+            if (b > a) spans.add(quint32((a - d0) / 1000000000LL), quint32((b - d0 + 999999999LL) / 1000000000LL));
+        }
+        q.finish();
+        storeCoverage_(cd.first, cd.second, spans);
+    }
+    return true;
 }
 
 void DbWriter::markError(const QString& where, const QString& detail) {
@@ -122,61 +355,228 @@ static bool hasColumn(QSqlDatabase& db, const QString& table, const QString& col
     return false;
 }
 
+static int schemaVersion(QSqlDatabase& db) {
+    QSqlQuery q(db);
+    if (q.exec("SELECT MAX(version) FROM schema_version;") && q.next()) return q.value(0).toInt();
+    return 0;
+}
+
+// Versioned, forward-only. Each step is idempotent and commits with its version
+// row, so an interrupted upgrade simply reruns on the next start.
 bool DbWriter::migrateSchema_() {
-    // Add 'pinned' only if missing on old DBs
-    if (!hasColumn(db_, "segments", "pinned")) {
-        if (!exec("ALTER TABLE segments ADD COLUMN pinned INTEGER DEFAULT 0;")) {
-            qWarning() << "[DB] migrate: add pinned failed";
-        } else {
-            exec("UPDATE segments SET pinned=0 WHERE pinned IS NULL;");
+    if (!exec("CREATE TABLE IF NOT EXISTS schema_version (version INTEGER NOT NULL,"
+              " applied_at INTEGER DEFAULT (strftime('%s','now')) );")) return false;
+    const int version = schemaVersion(db_);
+    auto step = [this](int v, const QStringList& sql) {
+        if (!db_.transaction()) return false;
+        for (const QString& stmt : sql) {
+            if (!exec(stmt)) { db_.rollback(); qWarning() << "[DB] migrate to" << v << "failed"; return false; }
+        }
+        if (!exec(QString("INSERT INTO schema_version(version) VALUES(%1);").arg(v))) { db_.rollback(); return false; }
+        if (!db_.commit()) { qWarning() << "[DB] migrate to" << v << "commit failed:" << db_.lastError().text(); return false; }
+        qInfo() << "[DB] schema migrated to version" << v;
+        return true;
+    };
+
+    // 1: 'pinned' flag and the purge planner indexes
+    if (version < 1) {
+        QStringList sql;
+        if (!hasColumn(db_, "segments", "pinned"))
+            sql << "ALTER TABLE segments ADD COLUMN pinned INTEGER DEFAULT 0;";
+        sql << "UPDATE segments SET pinned=0 WHERE pinned IS NULL;"
+            << "CREATE INDEX IF NOT EXISTS idx_segments_pinned ON segments(pinned);"
+            // Purge planner: only purgeable rows, already in deletion order
+            << "CREATE INDEX IF NOT EXISTS idx_segments_purge ON segments(start_utc_ns)"
+               " WHERE status=1 AND pinned=0;"
+            << "CREATE INDEX IF NOT EXISTS idx_segments_purge_cam ON segments(camera_id, start_utc_ns)"
+               " WHERE status=1 AND pinned=0;";
+        if (!step(1, sql)) return false;
+    }
+
+    // 2: every row carries camera_id and end_utc_ns, so readers never fall back
+    //    to camera_url matching and overlap queries are one index range scan
+    if (version < 2) {
+        const QStringList sql = {
+            // cameras that only survive as a URL on old rows
+            "INSERT OR IGNORE INTO cameras(name, main_url)"
+            " SELECT DISTINCT camera_url, camera_url FROM segments"
+            " WHERE camera_url IS NOT NULL AND camera_url<>''"
+            "   AND (camera_id IS NULL OR camera_id=0);",
+            "UPDATE segments SET camera_id=(SELECT id FROM cameras WHERE main_url=segments.camera_url)"
+            " WHERE (camera_id IS NULL OR camera_id=0) AND camera_url IS NOT NULL;",
+            "UPDATE segments SET end_utc_ns = CASE"
+            "   WHEN COALESCE(duration_ms,0) > 0 THEN start_utc_ns + duration_ms*1000000"
+            "   ELSE start_utc_ns END"
+            " WHERE end_utc_ns IS NULL OR end_utc_ns <= 0;",
+            "CREATE INDEX IF NOT EXISTS idx_segments_camera_end ON segments(camera_id, end_utc_ns);",
+            "DROP INDEX IF EXISTS idx_segments_camera_url_time;",
+        };
+        if (!step(2, sql)) return false;
+    }
+
+    // 3: camera_days, the date picker's index (kept current on segment open/delete)
+    if (version < 3) {
+        const QStringList sql = {
+            "CREATE TABLE IF NOT EXISTS camera_days ("
+            " camera_id INTEGER NOT NULL, day TEXT NOT NULL, segments INTEGER NOT NULL DEFAULT 0,"
+            " PRIMARY KEY(camera_id, day) ) WITHOUT ROWID;",
+            "DELETE FROM camera_days;",
+            "INSERT INTO camera_days(camera_id, day, segments)"
+            " SELECT camera_id, strftime('%Y-%m-%d', datetime(start_utc_ns/1000000000,'unixepoch','localtime')), COUNT(*)"
+            " FROM segments WHERE camera_id IS NOT NULL AND status IN (0,1) GROUP BY 1, 2;",
+        };
+        if (!step(3, sql)) return false;
+    }
+
+    // 4: camera_coverage, the timeline's recorded spans (kept current on segment finalize/delete)
+    if (version < 4) {
+        QHash<QPair<int, QString>, CoverageSpans> byDay;
+        QSqlQuery q(db_);
+        q.setForwardOnly(true);
+        if (!q.exec("SELECT camera_id, start_utc_ns, end_utc_ns FROM segments"
+                    " WHERE status=1 AND camera_id IS NOT NULL;")) {
+            qWarning() << "[DB] coverage backfill:" << q.lastError().text();
+            return false;
+        }
+        while (q.next()) {
+            const int cam = q.value(0).toInt();
+            CoverageSpans::forEachDay(q.value(1).toLongLong(), q.value(2).toLongLong(),
+                                      [&](const QDate& day, quint32 a, quint32 b){
+                byDay[{ cam, day.toString("yyyy-MM-dd") }].add(a, b);
+            });
+        }
+        q.finish();
+        QStringList sql = {
+            "CREATE TABLE IF NOT EXISTS camera_coverage ("
+            " camera_id INTEGER NOT NULL, day TEXT NOT NULL, spans BLOB NOT NULL,"
+            " PRIMARY KEY(camera_id, day) ) WITHOUT ROWID;",
+            "DELETE FROM camera_coverage;"
+        };
+        for (auto it = byDay.cbegin(); it != byDay.cend(); ++it) {
+            sql << QString("INSERT INTO camera_coverage(camera_id, day, spans) VALUES(%1, '%2', x'%3');")
+                       .arg(it.key().first).arg(it.key().second)
+                       .arg(QString::fromLatin1(it.value().toBlob().toHex()));
         }
+        if (!step(4, sql)) return false;
     }
-    // Create indexes that depend on the column
-    exec("CREATE INDEX IF NOT EXISTS idx_segments_pinned ON segments(pinned);");
     return true;
 }
 
 
-QVector<QPair<qint64, QString>> DbWriter::oldestFinalizedUnpinned(int limit, int cameraId, int minDays) {
+QVector<QPair<qint64, QString>> DbWriter::purgeCandidates(int cameraId, qint64 beforeUtcNs, int limit) {
+    flushPending();
+    static MetricHistogram& h = statementSeconds("purge_candidates");
+    MetricTimer t(h);
     QVector<QPair<qint64, QString>> out;
-    QSqlQuery q(db_);
-    QString sql = R"SQL(
-      SELECT id, file_path
-      FROM segments
-      WHERE status=1 AND pinned=0
-        %1
-        %2
-      ORDER BY start_utc_ns ASC
-      LIMIT :lim
-    )SQL";
-    const QString cam = cameraId>0 ? "AND (camera_id=:cid OR camera_url=(SELECT main_url FROM cameras WHERE id=:cid))" : "";
-    const QString age = minDays>0 ? "AND start_utc_ns < ((strftime('%s','now') - :age)*1000000000)" : "";
-    q.prepare(sql.arg(cam, age));
-    if (cameraId>0) q.bindValue(":cid", cameraId);
-    if (minDays>0) q.bindValue(":age", minDays*24*3600);
-    q.bindValue(":lim", limit);
-    if (!q.exec()) { qWarning() << "[DB] oldestFinalizedUnpinned:" << q.lastError().text(); return out; }
+    // Ledger bucket 0 is COALESCE(camera_id,0); "camera_id=0" would never match NULL.
+    QSqlQuery& q = cameraId > 0 ? stPurgeCam_ : cameraId == 0 ? stPurgeLegacy_ : stPurgeAll_;
+    int i = 0;
+    if (cameraId > 0) q.bindValue(i++, cameraId);
+    q.bindValue(i++, beforeUtcNs);
+    q.bindValue(i, limit);
+    if (!q.exec()) { qWarning() << "[DB] purgeCandidates:" << q.lastError().text(); return out; }
     while (q.next()) out.push_back({ q.value(0).toLongLong(), q.value(1).toString() });
+    q.finish();
     return out;
 }
 
+QHash<QString, int> DbWriter::cameraIdsByUrl() {
+    return cameraIds_;
+}
+
 bool DbWriter::deleteSegmentRow(qint64 segmentId) {
+    return deleteSegmentRows({ segmentId }) >= 0;
+}
+
+qint64 DbWriter::deleteSegmentRows(const QVector<qint64>& segmentIds) {
+    if (segmentIds.isEmpty()) return 0;
+    flushPending();
+    static MetricHistogram& h = statementSeconds("segment_delete");
+    MetricTimer t(h);
+    QStringList ids;
+    ids.reserve(segmentIds.size());
+    for (qint64 id : segmentIds) ids << QString::number(id);
+    const QString in = ids.join(',');
+
+    if (!db_.transaction()) { qWarning() << "[DB] deleteSegmentRows: begin failed:" << db_.lastError().text(); return -1; }
+    struct Gone { int cameraId; qint64 startNs; qint64 endNs; qint64 bytes; };
+    QVector<Gone> gone;
+    qint64 bytes = 0;
     QSqlQuery q(db_);
-    q.prepare("DELETE FROM segments WHERE id=?;");
-    q.addBindValue(segmentId);
-    if (!q.exec()) { qWarning() << "[DB] deleteSegmentRow:" << q.lastError().text(); return false; }
-    return true;
+    if (!q.exec(QString("SELECT camera_id, start_utc_ns, COALESCE(size_bytes,0), end_utc_ns FROM segments"
+                        " WHERE id IN (%1);").arg(in))) {
+        qWarning() << "[DB] deleteSegmentRows:" << q.lastError().text();
+        db_.rollback();
+        return -1;
+    }
+    while (q.next()) {
+        const qint64 sz = q.value(2).toLongLong();
+        gone.push_back({ q.value(0).toInt(), q.value(1).toLongLong(), q.value(3).toLongLong(), sz });
+        bytes += sz;
+    }
+    if (!q.exec(QString("DELETE FROM segments WHERE id IN (%1);").arg(in))) {
+        qWarning() << "[DB] deleteSegmentRows:" << q.lastError().text();
+        db_.rollback();
+        return -1;
+    }
+    QVector<QPair<int, qint64>> cameraStarts;
+    cameraStarts.reserve(gone.size());
+    for (const auto& g : gone) cameraStarts.push_back({ g.cameraId, g.startNs });
+    if (!dropDays_(cameraStarts)) { db_.rollback(); return -1; }
+    QSet<QPair<int, QString>> coverageDays;
+    for (const auto& g : gone) {
+        CoverageSpans::forEachDay(g.startNs, qMax(g.endNs, g.startNs + 1), [&](const QDate& day, quint32, quint32){
+            coverageDays.insert({ g.cameraId, day.toString("yyyy-MM-dd") });
+        });
+    }
+    if (!rebuildCoverage_(coverageDays)) { db_.rollback(); return -1; }
+    if (!db_.commit()) { qWarning() << "[DB] deleteSegmentRows: commit failed:" << db_.lastError().text(); return -1; }
+    if (ledger_) for (const auto& g : gone) ledger_->removeSegment(g.cameraId, g.startNs, g.bytes);
+    return bytes;
 }
 
-bool DbWriter::markPinned(const QString& filePath, bool pinned) {
+QVector<StorageLedger::Usage> DbWriter::finalizedUsage(QHash<int, QString>* cameraNames,
+                                                       QHash<StorageLedger::SegmentKey, qint64>* openOnDisk) {
+    flushPending();
+    QVector<StorageLedger::Usage> out;
     QSqlQuery q(db_);
-    q.prepare("UPDATE segments SET pinned=? WHERE file_path=?;");
-    q.addBindValue(pinned ? 1 : 0);
-    q.addBindValue(filePath);
-    if (!q.exec()) { qWarning() << "[DB] markPinned:" << q.lastError().text(); return false; }
+    // Local days, as camera_days keys them
+    if (!q.exec("SELECT COALESCE(camera_id,0),"
+                " strftime('%Y-%m-%d', datetime(start_utc_ns/1000000000,'unixepoch','localtime')),"
+                " SUM(COALESCE(size_bytes,0))"
+                " FROM segments WHERE status=1 GROUP BY 1, 2;")) {
+        qWarning() << "[DB] finalizedUsage:" << q.lastError().text();
+        return out;
+    }
+    while (q.next()) {
+        out.push_back({ q.value(0).toInt(), QDate::fromString(q.value(1).toString(), "yyyy-MM-dd"),
+                        q.value(2).toLongLong() });
+    }
+
+    if (cameraNames && q.exec("SELECT id, name FROM cameras;")) {
+        while (q.next()) cameraNames->insert(q.value(0).toInt(), q.value(1).toString());
+    }
+    // st_blocks rather than st_size: what the open file holds on disk, preallocation
+    // and a recycled slot's extents included.
+    if (openOnDisk && q.exec("SELECT COALESCE(camera_id,0), start_utc_ns, file_path FROM segments WHERE status=0;")) {
+        while (q.next()) {
+            struct stat st;
+            if (::stat(QFile::encodeName(q.value(2).toString()).constData(), &st) != 0) continue;
+            openOnDisk->insert({ q.value(0).toInt(), q.value(1).toLongLong() }, qint64(st.st_blocks) * 512);
+        }
+    }
+    return out;
+}
+
+bool DbWriter::markPinned(const QString& filePath, bool pinned) {
+    flushPending();
+    stMarkPinned_.bindValue(0, pinned ? 1 : 0);
+    stMarkPinned_.bindValue(1, filePath);
+    if (!stMarkPinned_.exec()) { qWarning() << "[DB] markPinned:" << stMarkPinned_.lastError().text(); return false; }
     return true;
 }
 
 void DbWriter::checkpointWal() {
+    flushPending();
     exec("PRAGMA wal_checkpoint(TRUNCATE);");
 }
@@ -1,15 +1,26 @@
 #pragma once
 #include <QObject>
 #include <QSqlDatabase>
+#include <QSqlQuery>
 #include <QString>
 #include <QVector>
 #include <QPair>
+#include <QHash>
+#include <QSet>
+#include "storage_ledger.h"
+
+class QTimer;
+class CoverageSpans;
+
 class DbWriter : public QObject {
     Q_OBJECT
 public:
     explicit DbWriter(QObject* parent=nullptr);
     ~DbWriter();
 
+    // Finalize/purge keep the ledger current; set before the DB thread starts.
+    void setLedger(StorageLedger* ledger) { ledger_ = ledger; }
+
 public slots:
     bool openAt(const QString& dbFile);
     void ensureCamera(const QString& mainUrl, const QString& subUrl, const QString& name);
@@ -17,14 +28,72 @@ public slots:
     void addSegmentOpened(const QString& sessionId, const QString& cameraUrl,
                           const QString& filePath, qint64 startUtcNs);
     void finalizeSegmentByPath(const QString& filePath, qint64 endUtcNs, qint64 durationMs);
+    // Segment open/finalize are write-behind: commits queued ones now (readers below call it first).
+    void flushPending();
     void markError(const QString& where, const QString& detail);
-    QVector<QPair<qint64, QString>> oldestFinalizedUnpinned(int limit, int cameraId = 0, int minDays = 0);
+    // Retention planner: oldest finalized, unpinned rows started before beforeUtcNs,
+    // for one camera (cameraId > 0), the ledger's bucket 0 (camera_id NULL: legacy
+    // rows) or all (-1). One range scan on a partial index.
+    QVector<QPair<qint64, QString>> purgeCandidates(int cameraId, qint64 beforeUtcNs, int limit);
+    QHash<QString, int> cameraIdsByUrl();      // cached map, kept current by ensureCamera
     bool deleteSegmentRow(qint64 segmentId);
+    // Deletes all rows in one transaction; returns their summed size_bytes, -1 on failure.
+    qint64 deleteSegmentRows(const QVector<qint64>& segmentIds);
+    // Ledger reconciliation: finalized bytes per (camera, local day), camera names,
+    // and the allocated bytes of each still-open segment file.
+    QVector<StorageLedger::Usage> finalizedUsage(QHash<int, QString>* cameraNames,
+                                                 QHash<StorageLedger::SegmentKey, qint64>* openOnDisk = nullptr);
     bool markPinned(const QString& filePath, bool pinned);
     void checkpointWal();
 private:
     bool ensureSchema();
     bool migrateSchema_();
     bool exec(const QString& sql);
+    bool prepareStatements_();
+    void releaseStatements_();
+    int  cameraIdFor_(const QString& url);
+
+    struct PendingOp {
+        enum Kind { Open, Finalize } kind;
+        QString sessionId;
+        QString cameraUrl;
+        QString filePath;
+        qint64  utcNs;          // start (Open) or end (Finalize)
+        qint64  durationMs;
+    };
+    struct LedgerAdd { int cameraId; qint64 startNs; qint64 bytes; };
+    void enqueue_(PendingOp&& op);
+    bool writeOpened_(const PendingOp& op);
+    bool writeFinalized_(const PendingOp& op, QVector<LedgerAdd>& adds);
+    bool dropDays_(const QVector<QPair<int, qint64>>& cameraStarts);
+    void addCoverage_(int cameraId, qint64 startNs, qint64 endNs);
+    void storeCoverage_(int cameraId, const QString& day, const CoverageSpans& spans);
+    bool rebuildCoverage_(const QSet<QPair<int, QString>>& cameraDays);
+
+    QVector<PendingOp> pending_;
+    QTimer* flushTimer_ = nullptr;
+    int commitMs_ = 250;
+    int commitOps_ = 64;
     QSqlDatabase db_;
+    StorageLedger* ledger_ = nullptr;
+
+    // Prepared once in openAt(); positional binds are replaced on every use.
+    // Released before the connection is closed.
+    QSqlQuery stUpsertCamera_;
+    QSqlQuery stCameraId_;
+    QSqlQuery stInsertSegment_;
+    QSqlQuery stSegmentByPath_;
+    QSqlQuery stFinalizeSegment_;
+    QSqlQuery stPurgeCam_;
+    QSqlQuery stPurgeAll_;
+    QSqlQuery stPurgeLegacy_;
+    QSqlQuery stMarkPinned_;
+    QSqlQuery stBumpDay_;
+    QSqlQuery stDropDay_;
+    QSqlQuery stPruneDays_;
+    QSqlQuery stCoverageGet_;
+    QSqlQuery stCoveragePut_;
+    QSqlQuery stCoverageDel_;
+    QSqlQuery stCoverageRows_;
+    QHash<QString, int> cameraIds_;             // cameras.main_url -> id
 };
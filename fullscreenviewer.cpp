@@ -1,4 +1,6 @@
 #include "fullscreenviewer.h"
+#include <QOpenGLShaderProgram>
+#include <QOpenGLContext>
 #include <QPainter>
 #include <QDebug>
 #include <QKeyEvent>
@@ -8,6 +10,14 @@ FullScreenViewer::FullScreenViewer(QWindow *parent)
     : QOpenGLWindow(QOpenGLWindow::NoPartialUpdate, parent),
       closeButtonRect(width() - 50, 10, 40, 30) {}
 
+FullScreenViewer::~FullScreenViewer() {
+    if (context()) {
+        makeCurrent();
+        releaseGl_();
+        doneCurrent();
+    }
+}
+
 void FullScreenViewer::initializeGL() {
     initializeOpenGLFunctions();
     glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
@@ -15,6 +25,47 @@ void FullScreenViewer::initializeGL() {
     qDebug() << "[FS-Window] OpenGL initialized:";
     qDebug() << "Vendor:  " << reinterpret_cast<const char*>(glGetString(GL_VENDOR));
     qDebug() << "Renderer:" << reinterpret_cast<const char*>(glGetString(GL_RENDERER));
+
+    connect(context(), &QOpenGLContext::aboutToBeDestroyed, this, [this]{
+        makeCurrent();
+        releaseGl_();
+        doneCurrent();
+    });
+
+    program_ = createVideoProgram(context(), this);
+    if (!program_) return;
+    formatLoc_ = program_->uniformLocation("uFormat");
+
+    // One full-viewport quad; letterboxing is done with glViewport.
+    static const GLfloat quad[] = { -1.f,  1.f, 0.f, 0.f,  -1.f, -1.f, 0.f, 1.f,
+                                     1.f,  1.f, 1.f, 0.f,   1.f, -1.f, 1.f, 1.f };
+    vao_.create();
+    vao_.bind();
+    vbo_.create();
+    vbo_.bind();
+    vbo_.allocate(quad, sizeof(quad));
+    glEnableVertexAttribArray(0);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), nullptr);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat),
+                          reinterpret_cast<void*>(2 * sizeof(GLfloat)));
+    vbo_.release();
+    vao_.release();
+}
+
+void FullScreenViewer::releaseGl_() {
+    video_.release(this);
+    if (vbo_.isCreated()) vbo_.destroy();
+    if (vao_.isCreated()) vao_.destroy();
+    delete program_;
+    program_ = nullptr;
+}
+
+QRect FullScreenViewer::videoRect_() const {
+    const QSize fs = video_.frameSize;
+    if (fs.isEmpty()) return QRect(0, 0, width(), height());
+    const QSize fit = fs.scaled(size(), Qt::KeepAspectRatio);
+    return QRect(QPoint((width() - fit.width()) / 2, (height() - fit.height()) / 2), fit);
 }
 
 void FullScreenViewer::resizeGL(int w, int h) {
@@ -23,8 +74,30 @@ void FullScreenViewer::resizeGL(int w, int h) {
 }
 
 void FullScreenViewer::paintGL() {
+    repaintQueued_ = false;
     glClear(GL_COLOR_BUFFER_BIT);
 
+    if (!pending_.isNull()) {
+        LiveFrame frame;
+        std::swap(frame, pending_);
+        video_.upload(this, frame);
+    }
+    if (program_ && video_.hasImage && currentPixmap.isNull()) {
+        const qreal dpr = devicePixelRatio();
+        const QRect r = videoRect_();
+        glViewport(int(r.x() * dpr), int((height() - r.bottom() - 1) * dpr),
+                   int(r.width() * dpr), int(r.height() * dpr));
+        program_->bind();
+        vao_.bind();
+        video_.bind(this);
+        program_->setUniformValue(formatLoc_, int(video_.format));
+        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        GlVideoTexture::unbind(this);
+        vao_.release();
+        program_->release();
+        glViewport(0, 0, int(width() * dpr), int(height() * dpr));
+    }
+
     QPainter painter(this);
     if (!currentPixmap.isNull()) {
         painter.drawPixmap(0, 0, width(), height(), currentPixmap);
@@ -46,6 +119,27 @@ void FullScreenViewer::setImage(const QPixmap &pixmap) {
     update();
 }
 
+void FullScreenViewer::presentFrame(const LiveFrame &frame) {
+    if (frame.isNull()) return;
+    currentPixmap = QPixmap();
+    pending_ = frame;                 // older undrawn sample is dropped here
+    if (!repaintQueued_) {
+        repaintQueued_ = true;
+        update();
+    }
+}
+
+void FullScreenViewer::clearFrame() {
+    currentPixmap = QPixmap();
+    pending_ = LiveFrame();
+    if (context()) {
+        makeCurrent();
+        video_.release(this);
+        doneCurrent();
+    }
+    update();
+}
+
 void FullScreenViewer::keyPressEvent(QKeyEvent *event) {
     if (event->key() == Qt::Key_Escape) {
         close();
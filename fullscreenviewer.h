@@ -2,16 +2,28 @@
 
 #include <QOpenGLWindow>
 #include <QOpenGLFunctions>
+#include <QOpenGLBuffer>
+#include <QOpenGLVertexArrayObject>
 #include <QPixmap>
 #include <QRect>
+#include "gl_video_texture.h"
+
+class QOpenGLShaderProgram;
 
 class FullScreenViewer : public QOpenGLWindow, protected QOpenGLFunctions {
     Q_OBJECT
 
 public:
     explicit FullScreenViewer(QWindow *parent = nullptr);
+    ~FullScreenViewer() override;
     void setImage(const QPixmap &pixmap);
 
+public slots:
+    // Decoded sample (sub- or main-stream) uploaded straight to the window's GL surface.
+    void presentFrame(const LiveFrame &frame);
+    // Drop the current picture (pixmap and textures) before switching cameras.
+    void clearFrame();
+
 protected:
     void initializeGL() override;
     void resizeGL(int w, int h) override;
@@ -22,6 +34,17 @@ protected:
     void mousePressEvent(QMouseEvent *event) override;
 
 private:
+    void releaseGl_();
+    QRect videoRect_() const;          // aspect-fit rect for the current frame
+
     QPixmap currentPixmap;
     QRect closeButtonRect;
+
+    GlVideoTexture video_;
+    LiveFrame pending_;
+    bool repaintQueued_ = false;
+    QOpenGLShaderProgram* program_ = nullptr;
+    int formatLoc_ = -1;
+    QOpenGLBuffer vbo_{QOpenGLBuffer::VertexBuffer};
+    QOpenGLVertexArrayObject vao_;
 };
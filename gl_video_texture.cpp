@@ -0,0 +1,151 @@
+#include "gl_video_texture.h"
+#include <QOpenGLShaderProgram>
+#include <QOpenGLContext>
+#include <QDebug>
+
+static const char* kVertexSrc = R"GLSL(
+in vec2 aPos;
+in vec2 aTex;
+out vec2 vTex;
+void main() {
+    vTex = aTex;
+    gl_Position = vec4(aPos, 0.0, 1.0);
+}
+)GLSL";
+
+// uFormat: 0 = RGB, 1 = I420 (Y,U,V planes), 2 = NV12 (Y, interleaved UV). BT.601 limited range.
+static const char* kFragmentSrc = R"GLSL(
+in vec2 vTex;
+out vec4 fragColor;
+uniform int uFormat;
+uniform sampler2D uPlane0;
+uniform sampler2D uPlane1;
+uniform sampler2D uPlane2;
+void main() {
+    if (uFormat == 0) {
+        fragColor = vec4(texture(uPlane0, vTex).rgb, 1.0);
+        return;
+    }
+    float y = texture(uPlane0, vTex).r;
+    vec2 uv = (uFormat == 1)
+        ? vec2(texture(uPlane1, vTex).r, texture(uPlane2, vTex).r)
+        : texture(uPlane1, vTex).rg;
+    y = 1.16438 * (y - 0.0625);
+    uv -= vec2(0.5);
+    vec3 rgb = vec3(y + 1.59603 * uv.y,
+                    y - 0.39176 * uv.x - 0.81297 * uv.y,
+                    y + 2.01723 * uv.x);
+    fragColor = vec4(clamp(rgb, 0.0, 1.0), 1.0);
+}
+)GLSL";
+
+// Per-plane GL upload formats for the live formats we negotiate.
+struct PlaneFormat { GLint internal; GLenum format; };
+static bool planeFormatsFor(GstVideoFormat f, int& planes, PlaneFormat out[3]) {
+    switch (f) {
+    case GST_VIDEO_FORMAT_RGB:
+        planes = 1; out[0] = {GL_RGB8, GL_RGB};
+        return true;
+    case GST_VIDEO_FORMAT_I420:
+        planes = 3; out[0] = out[1] = out[2] = {GL_R8, GL_RED};
+        return true;
+    case GST_VIDEO_FORMAT_NV12:
+        planes = 2; out[0] = {GL_R8, GL_RED}; out[1] = {GL_RG8, GL_RG};
+        return true;
+    default:
+        return false;
+    }
+}
+
+// GLSL header matching the context the app was given (3.1 core on desktop, ES3 on ARM boxes).
+static QByteArray shaderHeader(const QOpenGLContext* ctx) {
+    if (ctx && ctx->isOpenGLES()) return "#version 300 es\nprecision mediump float;\n";
+    return "#version 140\n";
+}
+
+QOpenGLShaderProgram* createVideoProgram(QOpenGLContext* ctx, QObject* parent) {
+    const QByteArray hdr = shaderHeader(ctx);
+    auto* program = new QOpenGLShaderProgram(parent);
+    program->addShaderFromSourceCode(QOpenGLShader::Vertex,   hdr + kVertexSrc);
+    program->addShaderFromSourceCode(QOpenGLShader::Fragment, hdr + kFragmentSrc);
+    program->bindAttributeLocation("aPos", 0);
+    program->bindAttributeLocation("aTex", 1);
+    if (!program->link()) {
+        qWarning() << "[GL] video shader link failed:" << program->log();
+        delete program;
+        return nullptr;
+    }
+    program->bind();
+    program->setUniformValue("uPlane0", 0);
+    program->setUniformValue("uPlane1", 1);
+    program->setUniformValue("uPlane2", 2);
+    program->release();
+    return program;
+}
+
+// Map the sample once and push each plane straight into its texture.
+bool GlVideoTexture::upload(QOpenGLFunctions* gl, const LiveFrame& frame) {
+    GstVideoInfo info;
+    if (!frame.videoInfo(&info)) return false;
+    int n = 0;
+    PlaneFormat pf[kMaxPlanes];
+    const GstVideoFormat fmt = GST_VIDEO_INFO_FORMAT(&info);
+    if (!planeFormatsFor(fmt, n, pf)) {
+        qWarning() << "[GL] unsupported live format" << GST_VIDEO_INFO_NAME(&info);
+        return false;
+    }
+    GstVideoFrame vf;
+    if (!gst_video_frame_map(&vf, &info, frame.buffer(), GST_MAP_READ)) return false;
+
+    gl->glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    for (int p = 0; p < n; ++p) {
+        const int w = GST_VIDEO_FRAME_COMP_WIDTH(&vf, p);
+        const int h = GST_VIDEO_FRAME_COMP_HEIGHT(&vf, p);
+        if (!tex[p]) gl->glGenTextures(1, &tex[p]);
+        gl->glBindTexture(GL_TEXTURE_2D, tex[p]);
+        if (w != texW[p] || h != texH[p] || planes != n) {
+            gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            gl->glTexImage2D(GL_TEXTURE_2D, 0, pf[p].internal, w, h, 0,
+                             pf[p].format, GL_UNSIGNED_BYTE, nullptr);
+            texW[p] = w; texH[p] = h;
+        }
+        gl->glPixelStorei(GL_UNPACK_ROW_LENGTH,
+                          GST_VIDEO_FRAME_PLANE_STRIDE(&vf, p) / GST_VIDEO_FRAME_COMP_PSTRIDE(&vf, p));
+        gl->glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, w, h, pf[p].format, GL_UNSIGNED_BYTE,
+                            GST_VIDEO_FRAME_PLANE_DATA(&vf, p));
+    }
+    gl->glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    frameSize = QSize(GST_VIDEO_FRAME_WIDTH(&vf), GST_VIDEO_FRAME_HEIGHT(&vf));
+    gst_video_frame_unmap(&vf);
+
+    planes = n;
+    format = fmt == GST_VIDEO_FORMAT_I420 ? FmtI420
+           : fmt == GST_VIDEO_FORMAT_NV12 ? FmtNv12 : FmtRgb;
+    hasImage = true;
+    return true;
+}
+
+void GlVideoTexture::bind(QOpenGLFunctions* gl) const {
+    for (int p = 0; p < planes; ++p) {
+        gl->glActiveTexture(GL_TEXTURE0 + p);
+        gl->glBindTexture(GL_TEXTURE_2D, tex[p]);
+    }
+}
+
+void GlVideoTexture::unbind(QOpenGLFunctions* gl) {
+    for (int p = kMaxPlanes - 1; p >= 0; --p) {
+        gl->glActiveTexture(GL_TEXTURE0 + p);
+        gl->glBindTexture(GL_TEXTURE_2D, 0);
+    }
+}
+
+void GlVideoTexture::release(QOpenGLFunctions* gl) {
+    gl->glDeleteTextures(kMaxPlanes, tex);
+    for (int p = 0; p < kMaxPlanes; ++p) { tex[p] = 0; texW[p] = texH[p] = 0; }
+    planes = 0;
+    hasImage = false;
+    frameSize = QSize();
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <QOpenGLFunctions>
+#include "live_frame.h"
+
+class QOpenGLContext;
+class QOpenGLShaderProgram;
+class QObject;
+
+/**
+ * gl_video_texture
+ * ----------------
+ * Texture set for one decoded video stream, shared by the live grid and the
+ * fullscreen viewer.
+ * - RGB (1 plane), I420 (Y/U/V) or NV12 (Y/UV); textures are (re)allocated only
+ *   when the size or layout changes
+ * - upload() maps the sample once and pushes each plane with glTexSubImage2D
+ * - colour conversion happens in the program from createVideoProgram()
+ *   (attributes aPos=0/aTex=1, samplers uPlane0..2, int uniform uFormat)
+ * All calls need the owning context current.
+ */
+struct GlVideoTexture {
+    static constexpr int kMaxPlanes = 3;
+    enum ShaderFormat { FmtRgb = 0, FmtI420 = 1, FmtNv12 = 2 };
+
+    GLuint       tex[kMaxPlanes] = {0, 0, 0};
+    int          texW[kMaxPlanes] = {0, 0, 0};
+    int          texH[kMaxPlanes] = {0, 0, 0};
+    int          planes = 0;
+    ShaderFormat format = FmtRgb;
+    bool         hasImage = false;
+    QSize        frameSize;
+
+    bool upload(QOpenGLFunctions* gl, const LiveFrame& frame);
+    void bind(QOpenGLFunctions* gl) const;          // planes -> texture units 0..2
+    static void unbind(QOpenGLFunctions* gl);
+    void release(QOpenGLFunctions* gl);
+};
+
+// Linked YUV/RGB program for the current context, or nullptr (logged) on failure.
+QOpenGLShaderProgram* createVideoProgram(QOpenGLContext* ctx, QObject* parent);
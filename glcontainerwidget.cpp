@@ -0,0 +1,195 @@
+#include "glcontainerwidget.h"
+#include <QOpenGLShaderProgram>
+#include <QOpenGLContext>
+#include <QPainter>
+#include <QMouseEvent>
+#include <QDebug>
+
+GLContainerWidget::GLContainerWidget(QWidget *parent) : QOpenGLWidget(parent) {}
+
+GLContainerWidget::~GLContainerWidget() {
+    makeCurrent();
+    releaseGl_();
+    doneCurrent();
+}
+
+void GLContainerWidget::setGrid(int tileCount, int rows, int cols) {
+    if (context()) {
+        makeCurrent();
+        for (auto& t : tiles_) t.video.release(this);
+        doneCurrent();
+    }
+    tiles_ = QVector<Tile>(qMax(0, tileCount));
+    rows_ = qMax(1, rows);
+    cols_ = qMax(1, cols);
+    geometryDirty_ = true;
+    update();
+}
+
+void GLContainerWidget::setTileText(int index, const QString& text, const QColor& color) {
+    if (index < 0 || index >= tiles_.size()) return;
+    tiles_[index].text = text;
+    tiles_[index].textColor = color;
+    update();
+}
+
+void GLContainerWidget::setTileStale(int index, bool stale) {
+    if (index < 0 || index >= tiles_.size() || tiles_[index].stale == stale) return;
+    tiles_[index].stale = stale;
+    update();
+}
+
+bool GLContainerWidget::tileHasImage(int index) const {
+    if (index < 0 || index >= tiles_.size()) return false;
+    return tiles_[index].video.hasImage || !tiles_[index].pending.isNull();
+}
+
+QRect GLContainerWidget::tileRect(int index) const {
+    if (index < 0 || index >= tiles_.size() || cols_ <= 0 || rows_ <= 0) return {};
+    const int row = index / cols_;
+    const int col = index % cols_;
+    const int x0 = col * width() / cols_;
+    const int x1 = (col + 1) * width() / cols_;
+    const int y0 = row * height() / rows_;
+    const int y1 = (row + 1) * height() / rows_;
+    return QRect(x0, y0, x1 - x0, y1 - y0)
+        .adjusted(kTileMarginPx, kTileMarginPx, -kTileMarginPx, -kTileMarginPx);
+}
+
+int GLContainerWidget::tileAt(const QPoint& pos) const {
+    for (int i = 0; i < tiles_.size(); ++i)
+        if (tileRect(i).contains(pos)) return i;
+    return -1;
+}
+
+void GLContainerWidget::presentFrame(int index, const LiveFrame& frame) {
+    if (index < 0 || index >= tiles_.size() || frame.isNull()) return;
+    tiles_[index].pending = frame;   // older undrawn sample is dropped here
+    if (!repaintQueued_) {
+        repaintQueued_ = true;
+        update();
+    }
+}
+
+void GLContainerWidget::initializeGL() {
+    initializeOpenGLFunctions();
+    qDebug() << "[GL] OpenGL initialized";
+    qDebug() << "Vendor:" << reinterpret_cast<const char*>(glGetString(GL_VENDOR));
+    qDebug() << "Renderer:" << reinterpret_cast<const char*>(glGetString(GL_RENDERER));
+    qDebug() << "Version:" << reinterpret_cast<const char*>(glGetString(GL_VERSION));
+
+    connect(context(), &QOpenGLContext::aboutToBeDestroyed, this, [this]{
+        makeCurrent();
+        releaseGl_();
+        doneCurrent();
+    });
+
+    program_ = createVideoProgram(context(), this);
+    if (!program_) return;
+    formatLoc_ = program_->uniformLocation("uFormat");
+
+    vao_.create();
+    vbo_.create();
+    vbo_.setUsagePattern(QOpenGLBuffer::DynamicDraw);
+    geometryDirty_ = true;
+}
+
+void GLContainerWidget::resizeGL(int, int) {
+    geometryDirty_ = true;
+}
+
+// One quad (triangle strip: TL, BL, TR, BR) per tile, packed as x,y,u,v in NDC.
+void GLContainerWidget::rebuildGeometry_() {
+    geometryDirty_ = false;
+    if (!program_ || tiles_.isEmpty() || width() <= 0 || height() <= 0) return;
+
+    QVector<GLfloat> v;
+    v.reserve(tiles_.size() * 16);
+    const float W = float(width()), H = float(height());
+    for (int i = 0; i < tiles_.size(); ++i) {
+        const QRectF r = QRectF(tileRect(i)).adjusted(kTileBorderPx, kTileBorderPx,
+                                                      -kTileBorderPx, -kTileBorderPx);
+        const float l = 2.0f * float(r.left())   / W - 1.0f;
+        const float rr= 2.0f * float(r.right())  / W - 1.0f;
+        const float t = 1.0f - 2.0f * float(r.top())    / H;
+        const float b = 1.0f - 2.0f * float(r.bottom()) / H;
+        const GLfloat quad[] = { l, t, 0.f, 0.f,   l, b, 0.f, 1.f,
+                                 rr, t, 1.f, 0.f,  rr, b, 1.f, 1.f };
+        for (GLfloat f : quad) v.push_back(f);
+    }
+
+    vao_.bind();
+    vbo_.bind();
+    vbo_.allocate(v.constData(), int(v.size() * sizeof(GLfloat)));
+    glEnableVertexAttribArray(0);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), nullptr);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat),
+                          reinterpret_cast<void*>(2 * sizeof(GLfloat)));
+    vbo_.release();
+    vao_.release();
+}
+
+void GLContainerWidget::paintGL() {
+    repaintQueued_ = false;
+
+    glClearColor(0.0f, 0.05f, 0.1f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    if (program_ && !tiles_.isEmpty()) {
+        if (geometryDirty_) rebuildGeometry_();
+        program_->bind();
+        vao_.bind();
+        // Single pass: upload whatever arrived since the last vsync, then draw every tile.
+        for (int i = 0; i < tiles_.size(); ++i) {
+            Tile& t = tiles_[i];
+            if (!t.pending.isNull()) {
+                LiveFrame frame;
+                std::swap(frame, t.pending);
+                t.video.upload(this, frame);
+            }
+            if (!t.video.hasImage) continue;
+            t.video.bind(this);
+            program_->setUniformValue(formatLoc_, int(t.video.format));
+            glDrawArrays(GL_TRIANGLE_STRIP, i * 4, 4);
+        }
+        GlVideoTexture::unbind(this);
+        vao_.release();
+        program_->release();
+    }
+
+    // Borders + status text (same look as the old per-camera labels)
+    QPainter p(this);
+    p.setRenderHint(QPainter::Antialiasing);
+    QFont f = p.font(); f.setPixelSize(18); p.setFont(f);
+    for (int i = 0; i < tiles_.size(); ++i) {
+        const QRect r = tileRect(i);
+        const Tile& t = tiles_[i];
+        p.setPen(QPen(QColor("#333"), kTileBorderPx));
+        p.setBrush(t.video.hasImage ? Qt::NoBrush : QBrush(Qt::black));
+        p.drawRoundedRect(r, 5, 5);
+        if (t.video.hasImage && t.stale) {
+            p.fillRect(r, QColor(0, 0, 0, 150));
+        }
+        if ((!t.video.hasImage || t.stale) && !t.text.isEmpty()) {
+            p.setPen(t.textColor);
+            p.drawText(r, Qt::AlignCenter, t.text);
+        }
+    }
+}
+
+void GLContainerWidget::mousePressEvent(QMouseEvent* event) {
+    if (event->button() == Qt::LeftButton) {
+        const int idx = tileAt(event->pos());
+        if (idx >= 0) emit tileClicked(idx);
+    }
+    QOpenGLWidget::mousePressEvent(event);
+}
+
+void GLContainerWidget::releaseGl_() {
+    for (auto& t : tiles_) t.video.release(this);
+    if (vbo_.isCreated()) vbo_.destroy();
+    if (vao_.isCreated()) vao_.destroy();
+    delete program_;
+    program_ = nullptr;
+}
@@ -4,28 +4,73 @@
 
 #include <QOpenGLWidget>
 #include <QOpenGLFunctions>
-#include <QDebug>
+#include <QOpenGLBuffer>
+#include <QOpenGLVertexArrayObject>
+#include <QColor>
+#include <QVector>
+#include "live_frame.h"
+#include "gl_video_texture.h"
 
+class QOpenGLShaderProgram;
+
+// Live grid compositor (single GL context for the whole wall).
+// - owns one texture set per camera tile (RGB, or Y/U/V / Y/UV planes for I420/NV12)
+// - colour conversion and scaling happen in the fragment shader
+// - frames only mark tiles dirty; all uploads + draws happen in one pass per vsync
+// - tiles follow the LayoutManager grid (rows x cols), stretched like the old labels
+// - emits tileClicked(index) for click-to-fullscreen
 class GLContainerWidget : public QOpenGLWidget, protected QOpenGLFunctions {
     Q_OBJECT
 
 public:
-    explicit GLContainerWidget(QWidget *parent = nullptr) : QOpenGLWidget(parent) {}
+    explicit GLContainerWidget(QWidget *parent = nullptr);
+    ~GLContainerWidget() override;
+
+    void setGrid(int tileCount, int rows, int cols);
+    void setTileText(int index, const QString& text, const QColor& color = Qt::white);
+    // Stale tiles keep their last picture, dimmed, with the status text on top.
+    void setTileStale(int index, bool stale);
+    bool tileHasImage(int index) const;
+    int  tileAt(const QPoint& pos) const;
+    QRect tileRect(int index) const;
+
+public slots:
+    void presentFrame(int index, const LiveFrame& frame);
+
+signals:
+    void tileClicked(int index);
 
 protected:
-    void initializeGL() override {
-        initializeOpenGLFunctions();
-        qDebug() << "[GL] OpenGL initialized";
-        qDebug() << "Vendor:" << reinterpret_cast<const char*>(glGetString(GL_VENDOR));
-        qDebug() << "Renderer:" << reinterpret_cast<const char*>(glGetString(GL_RENDERER));
-        qDebug() << "Version:" << reinterpret_cast<const char*>(glGetString(GL_VERSION));
-    }
-
-    void paintGL() override {
-
-        glClearColor(0.0f, 0.05f, 0.1f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT);
-    }
+    void initializeGL() override;
+    void resizeGL(int w, int h) override;
+    void paintGL() override;
+    void mousePressEvent(QMouseEvent* event) override;
+
+private:
+    struct Tile {
+        GlVideoTexture video;
+        LiveFrame pending;          // newest undrawn sample; released after upload
+        QString   text;
+        QColor    textColor;
+        bool      stale = false;
+    };
+
+    void rebuildGeometry_();
+    void releaseGl_();
+
+    QVector<Tile> tiles_;
+    int rows_ = 0;
+    int cols_ = 0;
+    bool geometryDirty_ = true;
+    bool repaintQueued_ = false;    // at most one update() in flight per vsync
+
+    QOpenGLShaderProgram*    program_ = nullptr;
+    int                      formatLoc_ = -1;
+    QOpenGLBuffer            vbo_{QOpenGLBuffer::VertexBuffer};
+    QOpenGLVertexArrayObject vao_;
+
+    static constexpr int kTileMarginPx = 5;
+    static constexpr int kTileBorderPx = 2;
 };
 
 #endif // GLCONTAINERWIDGET_H
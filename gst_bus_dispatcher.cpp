@@ -0,0 +1,76 @@
+#include "gst_bus_dispatcher.h"
+#include <QThread>
+#include <QMutexLocker>
+#include <QDebug>
+
+GstBusDispatcher& GstBusDispatcher::instance() {
+    static GstBusDispatcher dispatcher;
+    return dispatcher;
+}
+
+GstBusDispatcher::GstBusDispatcher() {
+    gst_init(nullptr, nullptr);
+    context = g_main_context_new();
+    loop = g_main_loop_new(context, FALSE);
+
+    thread = QThread::create([this]{
+        g_main_context_push_thread_default(context);
+        g_main_loop_run(loop);
+        g_main_context_pop_thread_default(context);
+    });
+    thread->setObjectName("GstBusDispatcher");
+    thread->start();
+    qDebug() << "[Bus] Dispatcher thread started";
+}
+
+GstBusDispatcher::~GstBusDispatcher() {
+    g_main_loop_quit(loop);
+    thread->wait();
+    delete thread;
+
+    QMutexLocker lk(&dispatchMutex);
+    for (GSource* src : qAsConst(sources)) {
+        g_source_destroy(src);
+        g_source_unref(src);
+    }
+    sources.clear();
+    g_main_loop_unref(loop);
+    g_main_context_unref(context);
+}
+
+guint GstBusDispatcher::watch(GstElement* pipeline, Handler handler) {
+    if (!pipeline) return 0;
+    GstBus* bus = gst_element_get_bus(pipeline);
+    if (!bus) return 0;
+
+    GSource* src = gst_bus_create_watch(bus);
+    gst_object_unref(bus);
+
+    auto* entry = new Entry{this, std::move(handler)};
+    g_source_set_callback(src, reinterpret_cast<GSourceFunc>(&GstBusDispatcher::onMessage), entry,
+                          [](gpointer p){ delete static_cast<Entry*>(p); });
+
+    QMutexLocker lk(&dispatchMutex);
+    const guint token = g_source_attach(src, context);
+    sources.insert(token, src);
+    return token;
+}
+
+void GstBusDispatcher::unwatch(guint token) {
+    if (!token) return;
+    // Taking the dispatch mutex waits out a handler that is running right now.
+    QMutexLocker lk(&dispatchMutex);
+    GSource* src = sources.take(token);
+    if (!src) return;
+    g_source_destroy(src);
+    g_source_unref(src);
+}
+
+gboolean GstBusDispatcher::onMessage(GstBus*, GstMessage* message, gpointer user_data) {
+    auto* entry = static_cast<Entry*>(user_data);
+    QMutexLocker lk(&entry->owner->dispatchMutex);
+    // unwatch() may have won the race for the mutex; the source is then destroyed.
+    if (g_source_is_destroyed(g_main_current_source())) return G_SOURCE_REMOVE;
+    entry->handler(message);
+    return G_SOURCE_CONTINUE;
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <QHash>
+#include <QRecursiveMutex>
+#include <functional>
+#include <gst/gst.h>
+
+class QThread;
+
+/**
+ * gst_bus_dispatcher
+ * ------------------
+ * One process-wide GLib main loop that owns the bus watches of every pipeline.
+ * - watch(pipeline, handler) → token; handler runs on the dispatcher thread as
+ *   soon as a message is posted (no polling, no per-pipeline thread)
+ * - unwatch(token) removes the watch; once it returns the handler is not running
+ *   and will not be called again (safe to call from inside the handler)
+ * - handlers must stay short and must not block on the thread calling unwatch:
+ *   emit queued signals or flip flags, nothing more
+ */
+class GstBusDispatcher {
+public:
+    using Handler = std::function<void(GstMessage*)>;
+
+    static GstBusDispatcher& instance();
+
+    guint watch(GstElement* pipeline, Handler handler);
+    void  unwatch(guint token);
+
+private:
+    GstBusDispatcher();
+    ~GstBusDispatcher();
+    Q_DISABLE_COPY(GstBusDispatcher)
+
+    struct Entry {
+        GstBusDispatcher* owner;
+        Handler handler;
+    };
+    static gboolean onMessage(GstBus* bus, GstMessage* message, gpointer user_data);
+
+    GMainContext* context = nullptr;
+    GMainLoop*    loop = nullptr;
+    QThread*      thread = nullptr;
+
+    QRecursiveMutex dispatchMutex;        // held while a handler runs
+    QHash<guint, GSource*> sources;
+};
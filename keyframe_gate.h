@@ -0,0 +1,42 @@
+#pragma once
+#include <atomic>
+#include <gst/gst.h>
+
+/**
+ * KeyframeGate
+ * ------------
+ * Buffer probe for the compressed side of a live decode branch.
+ * - visible: every access unit passes
+ * - hidden: delta units are dropped before the decoder, so it decodes
+ *   keyframes only (about one frame per GOP)
+ * - hidden -> visible: deltas resume at the next keyframe, never mid-GOP
+ * setVisible() is safe from any thread; the probe runs on the streaming thread.
+ * The gate must outlive the pad it is attached to (pipeline at NULL).
+ */
+class KeyframeGate {
+public:
+    void setVisible(bool v) { visible_.store(v); }
+    bool isVisible() const  { return visible_.load(); }
+    // g_get_monotonic_time() of the last access unit seen (passed or dropped).
+    qint64 lastBufferUs() const { return lastBufferUs_.load(); }
+
+    void attach(GstPad* pad) {
+        if (pad) gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_BUFFER, &KeyframeGate::probe, this, nullptr);
+    }
+
+private:
+    static GstPadProbeReturn probe(GstPad*, GstPadProbeInfo* info, gpointer user_data) {
+        auto* gate = static_cast<KeyframeGate*>(user_data);
+        GstBuffer* buf = GST_PAD_PROBE_INFO_BUFFER(info);
+        gate->lastBufferUs_.store(g_get_monotonic_time());
+        if (!GST_BUFFER_FLAG_IS_SET(buf, GST_BUFFER_FLAG_DELTA_UNIT)) {
+            gate->passDeltas_ = gate->visible_.load();
+            return GST_PAD_PROBE_OK;
+        }
+        return gate->passDeltas_ ? GST_PAD_PROBE_OK : GST_PAD_PROBE_DROP;
+    }
+
+    std::atomic<bool> visible_{true};
+    std::atomic<qint64> lastBufferUs_{0};
+    bool passDeltas_ = true;            // streaming thread only
+};
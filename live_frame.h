@@ -0,0 +1,61 @@
+#pragma once
+#include <QMetaType>
+#include <QImage>
+#include <utility>
+#include <gst/gst.h>
+#include <gst/video/video.h>
+
+/**
+ * LiveFrame
+ * ---------
+ * Ref-counted handle on a decoded appsink sample.
+ * - copying only bumps the GstSample refcount, pixels are never duplicated
+ * - safe to pass through queued signals (registered metatype)
+ * - the renderer maps the buffer once and uploads straight to a GL texture
+ */
+class LiveFrame {
+public:
+    LiveFrame() = default;
+    explicit LiveFrame(GstSample* adopt) : sample_(adopt) {}      // takes ownership
+    LiveFrame(const LiveFrame& o) : sample_(o.sample_ ? gst_sample_ref(o.sample_) : nullptr) {}
+    LiveFrame(LiveFrame&& o) noexcept : sample_(o.sample_) { o.sample_ = nullptr; }
+    LiveFrame& operator=(LiveFrame o) noexcept { std::swap(sample_, o.sample_); return *this; }
+    ~LiveFrame() { if (sample_) gst_sample_unref(sample_); }
+
+    bool       isNull() const { return sample_ == nullptr; }
+    GstSample* sample() const { return sample_; }
+    GstBuffer* buffer() const { return sample_ ? gst_sample_get_buffer(sample_) : nullptr; }
+    GstCaps*   caps()   const { return sample_ ? gst_sample_get_caps(sample_)   : nullptr; }
+
+    // Parse caps into video info; false if the sample carries no raw video caps.
+    bool videoInfo(GstVideoInfo* info) const {
+        GstCaps* c = caps();
+        return c && gst_video_info_from_caps(info, c);
+    }
+
+    // Deep copy into a QImage. Only for consumers that still need a QPixmap
+    // (fullscreen fallback); the live grid never calls this.
+    // NV12/I420 samples are converted on the CPU here, so keep it off hot paths.
+    QImage toImage() const {
+        GstVideoInfo info;
+        if (!videoInfo(&info)) return {};
+        if (GST_VIDEO_INFO_FORMAT(&info) != GST_VIDEO_FORMAT_RGB) {
+            GstCaps* to = gst_caps_new_simple("video/x-raw", "format", G_TYPE_STRING, "RGB", nullptr);
+            GstSample* rgb = gst_video_convert_sample(sample_, to, GST_SECOND, nullptr);
+            gst_caps_unref(to);
+            return rgb ? LiveFrame(rgb).toImage() : QImage();
+        }
+        GstVideoFrame vf;
+        if (!gst_video_frame_map(&vf, &info, buffer(), GST_MAP_READ)) return {};
+        QImage img(static_cast<const uchar*>(GST_VIDEO_FRAME_PLANE_DATA(&vf, 0)),
+                   GST_VIDEO_FRAME_WIDTH(&vf), GST_VIDEO_FRAME_HEIGHT(&vf),
+                   GST_VIDEO_FRAME_PLANE_STRIDE(&vf, 0), QImage::Format_RGB888);
+        QImage out = img.copy();
+        gst_video_frame_unmap(&vf);
+        return out;
+    }
+
+private:
+    GstSample* sample_ = nullptr;
+};
+Q_DECLARE_METATYPE(LiveFrame)
@@ -9,10 +9,15 @@
 #include <QThread>
 #include <QScreen>
 
+#include "async_logger.h"
 #include "mainwindow.h"
+#include "metrics_server.h"
 
 int main(int argc, char *argv[])
 {
+    // Everything below logs through the async backend (never blocks the caller)
+    AsyncLogger::install();
+
     // OpenGL format setup
     QSurfaceFormat fmt;
     fmt.setRenderableType(QSurfaceFormat::OpenGL);
@@ -22,6 +27,9 @@ int main(int argc, char *argv[])
 
     QApplication app(argc, argv);
 
+    // /metrics on 127.0.0.1:$CAMVIGIL_METRICS_PORT (off when unset)
+    MetricsServer::startFromEnv();
+
     // loading the pixmap
     QPixmap pix(":/images/splash.png");
     qDebug() << "Splash loaded size:" << pix.size();
@@ -55,5 +63,7 @@ int main(int argc, char *argv[])
     else
         qDebug() << "No OpenGL context available yet.";
 
-    return app.exec();
+    const int rc = app.exec();
+    AsyncLogger::shutdown();
+    return rc;
 }
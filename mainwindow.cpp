@@ -20,6 +20,7 @@ MainWindow::MainWindow(QWidget *parent)
     , settingsWindow(nullptr)
     , fullScreenViewer(new FullScreenViewer)
     , currentFullScreenIndex(-1)
+    , liveHandoff(StreamManager::handoffFromEnv())
 {
     ui->setupUi(this);
 
@@ -47,26 +48,36 @@ MainWindow::MainWindow(QWidget *parent)
     layoutManager->calculateGridDimensions(numCameras, gridRows, gridCols);
     layoutManager->setupLayout(numCameras);
 
-    // clickable labels for each camera feed.
-    for (int i = 0; i < numCameras; ++i) {
-        ClickableLabel* label = new ClickableLabel(i, this);
+    GLContainerWidget* gridWidget = new GLContainerWidget(this);
+
+    // clickable labels for each camera feed (legacy pixmap wall); the GL grid draws its own tiles.
+    if (liveHandoff == FrameHandoff::Pixmap) {
+        for (int i = 0; i < numCameras; ++i) {
+            ClickableLabel* label = new ClickableLabel(i, this);
 
-        label->setAlignment(Qt::AlignCenter);
-        label->setScaledContents(true);
-        label->setStyleSheet("border:2px solid #333; border-radius:5px; margin:5px; padding:5px; background:#000;");
-        label->showLoading();
-        labels.push_back(label);
+            label->setAlignment(Qt::AlignCenter);
+            label->setScaledContents(true);
+            label->setStyleSheet("border:2px solid #333; border-radius:5px; margin:5px; padding:5px; background:#000;");
+            label->showLoading();
+            labels.push_back(label);
 
-        int row = i / gridCols;
-        int col = i % gridCols;
-        gridLayout->addWidget(label, row, col);
+            int row = i / gridCols;
+            int col = i % gridCols;
+            gridLayout->addWidget(label, row, col);
 
-        // Connecting each label's clicked signal.
-        connect(label, &ClickableLabel::clicked, this, &MainWindow::showFullScreenFeed);
+            // Connecting each label's clicked signal.
+            connect(label, &ClickableLabel::clicked, this, &MainWindow::showFullScreenFeed);
+        }
     }
 
-    GLContainerWidget* gridWidget = new GLContainerWidget(this);
-    gridWidget->setLayout(gridLayout);
+    if (liveHandoff == FrameHandoff::Pixmap) {
+        gridWidget->setLayout(gridLayout);
+    } else {
+        liveGrid = gridWidget;
+        liveGrid->setGrid(numCameras, gridRows, gridCols);
+        for (int i = 0; i < numCameras; ++i) liveGrid->setTileText(i, "Loading...");
+        connect(liveGrid, &GLContainerWidget::tileClicked, this, &MainWindow::showFullScreenFeed);
+    }
 
     QVBoxLayout* mainLayout = new QVBoxLayout();
     mainLayout->setContentsMargins(0, 0, 0, 0);
@@ -82,13 +93,11 @@ MainWindow::MainWindow(QWidget *parent)
 
     setWindowFlags(Qt::Window | Qt::WindowMinimizeButtonHint | Qt::WindowMaximizeButtonHint | Qt::WindowCloseButtonHint);
 
-    // Starting streaming: now directly use the profiles (which include the suburl for streaming)
-    std::vector<QLabel*> labelPtrs(labels.begin(), labels.end());
-
-//    streamManager->startStreaming(profiles, labelPtrs);
+//    streamManager->startStreaming(profiles);
 
     archiveManager = new ArchiveManager(this);
     archiveManager->startRecording(profiles);
+    connect(fullScreenViewer, &QWindow::visibleChanged, this, &MainWindow::updateLiveVisibility);
     QTimer::singleShot(0, this, &MainWindow::startStreamingAsync);
 }
 
@@ -96,6 +105,7 @@ MainWindow::MainWindow(QWidget *parent)
 void MainWindow::openSettingsWindow() {
     if (!settingsWindow) {
         settingsWindow = new SettingsWindow(archiveManager, cameraManager, this);
+        settingsWindow->installEventFilter(this);
     }
     settingsWindow->setWindowFlags(Qt::Window | Qt::FramelessWindowHint);
     settingsWindow->showFullScreen();
@@ -110,9 +120,11 @@ void MainWindow::openPlaybackWindow() {
            playbackWindow = new PlaybackWindow(nullptr);
            playbackWindow->setAttribute(Qt::WA_DeleteOnClose, true);
            playbackWindow->setWindowFlags(Qt::Window | Qt::FramelessWindowHint);
+           playbackWindow->installEventFilter(this);
            connect(playbackWindow, &QObject::destroyed, this, [this]{
                qInfo() << "[Main] PlaybackWindow destroyed, clearing pointer";
                playbackWindow = nullptr;
+               updateLiveVisibility();
            });
            created = true;
        }
@@ -144,14 +156,68 @@ void MainWindow::resizeEvent(QResizeEvent* event) {
     }
 }
 
+void MainWindow::changeEvent(QEvent* event) {
+    QMainWindow::changeEvent(event);
+    if (event->type() == QEvent::WindowStateChange) updateLiveVisibility();
+}
+
+bool MainWindow::eventFilter(QObject* obj, QEvent* event) {
+    if ((obj == settingsWindow || obj == playbackWindow.data()) &&
+        (event->type() == QEvent::Show || event->type() == QEvent::Hide ||
+         event->type() == QEvent::WindowStateChange)) {
+        QTimer::singleShot(0, this, &MainWindow::updateLiveVisibility);
+    }
+    if (obj == settingsWindow && event->type() == QEvent::Hide && archiveManager)
+        archiveManager->refreshRetentionPolicies(cameraManager->getCameraProfiles());
+    return QMainWindow::eventFilter(obj, event);
+}
+
+// Push per-tile visibility to whichever side decodes the wall. Hidden tiles drop
+// to keyframe-only decode; recording never changes.
+void MainWindow::updateLiveVisibility() {
+    const auto coversWall = [](QWidget* w) { return w && w->isVisible() && w->isFullScreen(); };
+    const bool wallHidden = isMinimized() || !isVisible()
+                          || coversWall(settingsWindow) || coversWall(playbackWindow.data());
+    const bool viewerUp = fullScreenViewer->isVisible();
+    const bool shared = archiveManager && ArchiveManager::sharedIngestFromEnv();
+
+    const int n = static_cast<int>(cameraManager->getCameraProfiles().size());
+    if (liveVisible.size() != n) liveVisible = QVector<bool>(n, true);  // workers start visible
+    for (int i = 0; i < n; ++i) {
+        const bool visible = viewerUp ? (i == currentFullScreenIndex) : !wallHidden;
+        if (liveVisible[i] == visible) continue;
+        liveVisible[i] = visible;
+        if (shared) {
+            archiveManager->setLiveVisible(i, visible);
+        } else {
+            QMetaObject::invokeMethod(streamManager, "setLiveVisible", Qt::QueuedConnection,
+                                      Q_ARG(int, i), Q_ARG(bool, visible));
+        }
+    }
+}
+
 void MainWindow::showFullScreenFeed(int index) {
     currentFullScreenIndex = index;
-    QVariant pixmapVar = labels[index]->property("pixmap");
-    QPixmap pixmap = pixmapVar.value<QPixmap>();
-    if (!pixmap.isNull()) {
+    fullScreenMainLive = false;
+    if (liveGrid) {
+        // Viewer shows substream samples until the full-resolution path delivers
+        if (!liveGrid->tileHasImage(index)) return;
+        fullScreenViewer->clearFrame();
+    } else {
+        QVariant pixmapVar = labels[index]->property("pixmap");
+        QPixmap pixmap = pixmapVar.value<QPixmap>();
+        if (pixmap.isNull()) return;
         fullScreenViewer->setImage(pixmap);
-        fullScreenViewer->showFullScreen();
-        fullScreenViewer->raise();
+    }
+    fullScreenViewer->showFullScreen();
+    fullScreenViewer->raise();
+
+    // Full resolution only while the viewer is up (torn down on visibleChanged)
+    if (archiveManager && ArchiveManager::sharedIngestFromEnv()) {
+        archiveManager->setFullResolution(index, true);
+    } else {
+        QMetaObject::invokeMethod(streamManager, "startMainStream", Qt::QueuedConnection,
+                                  Q_ARG(int, index));
     }
 }
 
@@ -167,31 +233,113 @@ MainWindow::~MainWindow() {
 }
 
 void MainWindow::startStreamingAsync() {
+    if (archiveManager && ArchiveManager::sharedIngestFromEnv()) {
+        // Recorder sessions already decode for the wall; no separate sub-stream clients.
+        connect(archiveManager, &ArchiveManager::liveFrameReady, this, [this](int idx, const LiveFrame &frame){
+            if (liveGrid) liveGrid->presentFrame(idx, frame);
+            if (!fullScreenMainLive && fullScreenViewer->isVisible() && idx == currentFullScreenIndex)
+                fullScreenViewer->presentFrame(frame);
+        });
+        connect(archiveManager, &ArchiveManager::fullFrameReady, this, [this](int idx, const LiveFrame &frame){
+            if (fullScreenViewer->isVisible() && idx == currentFullScreenIndex) {
+                fullScreenMainLive = true;
+                fullScreenViewer->presentFrame(frame);
+            }
+        });
+        connect(fullScreenViewer, &QWindow::visibleChanged, this, [this](bool visible){
+            if (!visible && currentFullScreenIndex >= 0)
+                archiveManager->setFullResolution(currentFullScreenIndex, false);
+            if (!visible) fullScreenMainLive = false;
+        });
+        // The recorder owns the only RTSP session: its supervisor state drives the tiles
+        connect(archiveManager, &ArchiveManager::recordingHealthChanged, this, [this](int idx, StreamHealth state){
+            if (!liveGrid) return;
+            if (state == StreamHealth::Live) {
+                liveGrid->setTileStale(idx, false);
+            } else if (state == StreamHealth::BackingOff) {
+                if (liveGrid->tileHasImage(idx)) {
+                    liveGrid->setTileText(idx, "⟳ Reconnecting…", QColor("#f0c040"));
+                    liveGrid->setTileStale(idx, true);
+                } else {
+                    liveGrid->setTileText(idx, "❌ Camera Unavailable", Qt::red);
+                }
+            }
+        });
+        return;
+    }
+
     QThread* thread = new QThread;
     streamManager = new StreamManager;
 
     streamManager->moveToThread(thread);
 
     auto profiles = cameraManager->getCameraProfiles();
-    std::vector<QLabel*> labelPtrs(labels.begin(), labels.end());
 
     connect(thread, &QThread::started, [=]() {
-        streamManager->startStreaming(profiles, labelPtrs);
+        streamManager->startStreaming(profiles);
     });
 
     // Forward frame updates to UI
     connect(streamManager, &StreamManager::frameReady, this, [this](int idx, const QPixmap &pixmap){
         labels[idx]->setPixmap(pixmap);
-        if (fullScreenViewer->isVisible() && idx == currentFullScreenIndex){
+        if (!fullScreenMainLive && fullScreenViewer->isVisible() && idx == currentFullScreenIndex){
         fullScreenViewer->setImage(pixmap);
         }
     });
+    connect(streamManager, &StreamManager::sampleReady, this, [this](int idx, const LiveFrame &frame){
+        if (liveGrid) liveGrid->presentFrame(idx, frame);
+        if (!fullScreenMainLive && fullScreenViewer->isVisible() && idx == currentFullScreenIndex) {
+            fullScreenViewer->presentFrame(frame);
+        }
+    });
+    // Fullscreen main stream: starts in showFullScreenFeed(), stops when the viewer hides
+    connect(streamManager, &StreamManager::mainFrameReady, this, [this](int idx, const LiveFrame &frame){
+        if (fullScreenViewer->isVisible() && idx == currentFullScreenIndex) {
+            fullScreenMainLive = true;
+            fullScreenViewer->presentFrame(frame);
+        }
+    });
+    connect(streamManager, &StreamManager::mainStreamLost, this, [this](int idx){
+        if (idx == currentFullScreenIndex) fullScreenMainLive = false;
+    });
+    StreamManager* sm = streamManager;
+    connect(fullScreenViewer, &QWindow::visibleChanged, sm, [sm](bool visible){
+        if (!visible) sm->stopMainStream();
+    });
+    connect(fullScreenViewer, &QWindow::visibleChanged, this, [this](bool visible){
+        if (!visible) fullScreenMainLive = false;
+    });
+    connect(streamManager, &StreamManager::cameraUnavailable, this, [this](int idx){
+        if (liveGrid) {
+            liveGrid->setTileText(idx, "❌ Camera Unavailable", Qt::red);
+        } else if (idx >= 0 && idx < static_cast<int>(labels.size())) {
+            labels[idx]->setText("❌ Camera Unavailable");
+            labels[idx]->setAlignment(Qt::AlignCenter);
+            labels[idx]->setStyleSheet("color: red; font-size: 18px; font-weight: bold;");
+        }
+    });
+
+    // Supervisor state: dim frozen tiles while the camera reconnects
+    connect(streamManager, &StreamManager::healthChanged, this, [this](int idx, StreamHealth state){
+        if (!liveGrid) return;
+        if (state == StreamHealth::Live) {
+            liveGrid->setTileStale(idx, false);
+        } else if (state == StreamHealth::BackingOff && liveGrid->tileHasImage(idx)) {
+            liveGrid->setTileText(idx, "⟳ Reconnecting…", QColor("#f0c040"));
+            liveGrid->setTileStale(idx, true);
+        }
+    });
 
    // connect(streamManager, &StreamManager::finished, thread, &QThread::quit);
     connect(thread, &QThread::finished, streamManager, &QObject::deleteLater);
     connect(thread, &QThread::finished, thread, &QObject::deleteLater);
 
     thread->start();
+
+    // Anything pushed so far went to the constructor's placeholder manager; the
+    // cache would otherwise hide the current state from the one just swapped in.
+    liveVisible.clear();
+    updateLiveVisibility();
 }
 
 /*void MainWindow::showEvent(QShowEvent* event) {
@@ -15,6 +15,7 @@
 #include "cameramanager.h"       // Persistent camera management
 #include <QPointer>
 class PlaybackWindow;
+class GLContainerWidget;
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class MainWindow; }
@@ -29,6 +30,8 @@ public:
 
 protected:
     void resizeEvent(QResizeEvent* event) override;
+    void changeEvent(QEvent* event) override;
+    bool eventFilter(QObject* obj, QEvent* event) override;
 //    void showEvent(QShowEvent *event) override;
 
 private slots:
@@ -42,7 +45,9 @@ private:
     LayoutManager* layoutManager;
     StreamManager* streamManager;
     ArchiveManager* archiveManager;
-    std::vector<ClickableLabel*> labels;
+    std::vector<ClickableLabel*> labels;          // FrameHandoff::Pixmap only
+    GLContainerWidget* liveGrid = nullptr;        // renders tiles in FrameHandoff::Sample
+    FrameHandoff liveHandoff;
     int gridRows;
     int gridCols;
     CameraManager* cameraManager;  // Persistent CameraManager pointer
@@ -52,12 +57,17 @@ private:
     SettingsWindow* settingsWindow;
     FullScreenViewer* fullScreenViewer; // Reusable fullscreen viewer
     int currentFullScreenIndex;
+    bool fullScreenMainLive = false;  // main-stream frames reached the viewer; ignore substream
     QVector<ClickableLabel*> streamDisplayLabels;
         void startStreamingAsync();
         bool streamsStarted = false;
 
     QTimer* timeSyncTimer = nullptr;   //Manual camera time sync timer to send http request hourly basis
     QPointer<PlaybackWindow> playbackWindow;
+
+    // Live decode follows what is on screen (minimized, covered, fullscreen viewer)
+    void updateLiveVisibility();
+    QVector<bool> liveVisible;
 };
 
 #endif // MAINWINDOW_H
@@ -0,0 +1,119 @@
+#include "metrics_registry.h"
+#include <QMutexLocker>
+#include <QSet>
+#include <algorithm>
+
+MetricHistogram::MetricHistogram(std::vector<double> boundsSeconds)
+    : bounds_(std::move(boundsSeconds)),
+      buckets_(new std::atomic<quint64>[bounds_.size() + 1])
+{
+    std::sort(bounds_.begin(), bounds_.end());
+    for (size_t i = 0; i <= bounds_.size(); ++i) buckets_[i].store(0, std::memory_order_relaxed);
+}
+
+void MetricHistogram::observe(double seconds) {
+    const size_t i = size_t(std::lower_bound(bounds_.begin(), bounds_.end(), seconds) - bounds_.begin());
+    buckets_[i].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sumNs_.fetch_add(quint64(qMax(0.0, seconds) * 1e9), std::memory_order_relaxed);
+}
+
+MetricsRegistry& MetricsRegistry::instance() {
+    static MetricsRegistry registry;
+    return registry;
+}
+
+std::vector<double> MetricsRegistry::latencyBuckets() {
+    return { 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0 };
+}
+
+QString MetricsRegistry::label(const char* key, const QString& value) {
+    QString v = value;
+    v.replace('\\', "\\\\").replace('"', "\\\"").replace('\n', "\\n");
+    return QString("%1=\"%2\"").arg(key, v);
+}
+
+MetricsRegistry::Series& MetricsRegistry::findOrAdd_(const char* name, const char* help,
+                                                  const QString& labels, Type type) {
+    const QByteArray key = QByteArray(name) + '{' + labels.toUtf8() + '}';
+    QMutexLocker lk(&mutex_);
+    if (Series* s = index_.value(key)) return *s;
+
+    auto s = std::make_unique<Series>();
+    s->name = name;
+    s->help = help;
+    s->labels = labels.toUtf8();
+    s->type = type;
+    Series* raw = s.get();
+    seriesList_.push_back(std::move(s));
+    index_.insert(key, raw);
+    return *raw;
+}
+
+MetricCounter& MetricsRegistry::counter(const char* name, const char* help, const QString& labels) {
+    Series& s = findOrAdd_(name, help, labels, Type::Counter);
+    QMutexLocker lk(&mutex_);
+    if (!s.counter) s.counter = std::make_unique<MetricCounter>();
+    return *s.counter;
+}
+
+MetricGauge& MetricsRegistry::gauge(const char* name, const char* help, const QString& labels) {
+    Series& s = findOrAdd_(name, help, labels, Type::Gauge);
+    QMutexLocker lk(&mutex_);
+    if (!s.gauge) s.gauge = std::make_unique<MetricGauge>();
+    return *s.gauge;
+}
+
+MetricHistogram& MetricsRegistry::histogram(const char* name, const char* help, const QString& labels,
+                                            const std::vector<double>& bounds) {
+    Series& s = findOrAdd_(name, help, labels, Type::Histogram);
+    QMutexLocker lk(&mutex_);
+    if (!s.histogram) s.histogram = std::make_unique<MetricHistogram>(bounds);
+    return *s.histogram;
+}
+
+static QByteArray withLabels(const QByteArray& labels, const QByteArray& extra = QByteArray()) {
+    if (labels.isEmpty() && extra.isEmpty()) return QByteArray();
+    if (labels.isEmpty()) return '{' + extra + '}';
+    if (extra.isEmpty()) return '{' + labels + '}';
+    return '{' + labels + ',' + extra + '}';
+}
+
+QByteArray MetricsRegistry::render() const {
+    QMutexLocker lk(&mutex_);
+    QByteArray out;
+    QSet<QByteArray> described;
+    // Families are written together: HELP/TYPE once, then every labelled series.
+    for (const auto& head : seriesList_) {
+        if (described.contains(head->name)) continue;
+        described.insert(head->name);
+        const char* type = head->type == Type::Counter ? "counter"
+                         : head->type == Type::Gauge   ? "gauge" : "histogram";
+        out += "# HELP " + head->name + ' ' + head->help + '\n';
+        out += "# TYPE " + head->name + ' ' + type + '\n';
+
+        for (const auto& s : seriesList_) {
+            if (s->name != head->name) continue;
+            if (s->counter) {
+                out += s->name + withLabels(s->labels) + ' ' + QByteArray::number(s->counter->value()) + '\n';
+            } else if (s->gauge) {
+                out += s->name + withLabels(s->labels) + ' ' + QByteArray::number(s->gauge->value()) + '\n';
+            } else if (s->histogram) {
+                const MetricHistogram& h = *s->histogram;
+                quint64 cumulative = 0;
+                for (size_t i = 0; i < h.bounds().size(); ++i) {
+                    cumulative += h.bucket(i);
+                    out += s->name + "_bucket"
+                         + withLabels(s->labels, "le=\"" + QByteArray::number(h.bounds()[i], 'g', 6) + '"')
+                         + ' ' + QByteArray::number(cumulative) + '\n';
+                }
+                cumulative += h.bucket(h.bounds().size());
+                out += s->name + "_bucket" + withLabels(s->labels, "le=\"+Inf\"")
+                     + ' ' + QByteArray::number(cumulative) + '\n';
+                out += s->name + "_sum" + withLabels(s->labels) + ' ' + QByteArray::number(h.sumSeconds(), 'g', 9) + '\n';
+                out += s->name + "_count" + withLabels(s->labels) + ' ' + QByteArray::number(h.count()) + '\n';
+            }
+        }
+    }
+    return out;
+}
@@ -0,0 +1,102 @@
+#pragma once
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+/**
+ * metrics_registry
+ * ----------------
+ * Process-wide counters, gauges and histograms for NVR health.
+ * - hot paths only touch relaxed atomics: look a metric up once (registration
+ *   takes a mutex), keep the reference, then inc()/set()/observe() freely
+ * - series are identified by name + label text, e.g. camera="3"
+ * - render() produces the Prometheus text exposition format (MetricsServer)
+ * - histograms take seconds; default buckets span 0.5 ms .. 10 s
+ */
+class MetricCounter {
+public:
+    void inc(quint64 n = 1) { v_.fetch_add(n, std::memory_order_relaxed); }
+    quint64 value() const { return v_.load(std::memory_order_relaxed); }
+private:
+    std::atomic<quint64> v_{0};
+};
+
+class MetricGauge {
+public:
+    void set(qint64 v) { v_.store(v, std::memory_order_relaxed); }
+    void add(qint64 d) { v_.fetch_add(d, std::memory_order_relaxed); }
+    qint64 value() const { return v_.load(std::memory_order_relaxed); }
+private:
+    std::atomic<qint64> v_{0};
+};
+
+class MetricHistogram {
+public:
+    explicit MetricHistogram(std::vector<double> boundsSeconds);
+    void observe(double seconds);
+    void observeUs(qint64 us) { observe(double(us) / 1e6); }
+
+    const std::vector<double>& bounds() const { return bounds_; }
+    quint64 bucket(size_t i) const { return buckets_[i].load(std::memory_order_relaxed); }  // non-cumulative
+    quint64 count() const { return count_.load(std::memory_order_relaxed); }
+    double  sumSeconds() const { return double(sumNs_.load(std::memory_order_relaxed)) / 1e9; }
+
+private:
+    std::vector<double> bounds_;
+    std::unique_ptr<std::atomic<quint64>[]> buckets_;   // bounds_.size() + 1 (last = +Inf)
+    std::atomic<quint64> count_{0};
+    std::atomic<quint64> sumNs_{0};
+};
+
+// Observes the scope's wall time into a histogram.
+class MetricTimer {
+public:
+    explicit MetricTimer(MetricHistogram& h) : h_(h), t0_(std::chrono::steady_clock::now()) {}
+    ~MetricTimer() {
+        h_.observe(std::chrono::duration<double>(std::chrono::steady_clock::now() - t0_).count());
+    }
+private:
+    MetricHistogram& h_;
+    std::chrono::steady_clock::time_point t0_;
+};
+
+class MetricsRegistry {
+public:
+    static MetricsRegistry& instance();
+
+    MetricCounter&   counter(const char* name, const char* help, const QString& labels = QString());
+    MetricGauge&     gauge(const char* name, const char* help, const QString& labels = QString());
+    MetricHistogram& histogram(const char* name, const char* help, const QString& labels = QString(),
+                               const std::vector<double>& bounds = latencyBuckets());
+
+    QByteArray render() const;
+
+    static std::vector<double> latencyBuckets();
+    static QString label(const char* key, int value) { return QString("%1=\"%2\"").arg(key).arg(value); }
+    static QString label(const char* key, const QString& value);
+
+private:
+    enum class Type { Counter, Gauge, Histogram };
+    struct Series {
+        QByteArray name;
+        QByteArray help;
+        QByteArray labels;
+        Type type;
+        std::unique_ptr<MetricCounter>   counter;
+        std::unique_ptr<MetricGauge>     gauge;
+        std::unique_ptr<MetricHistogram> histogram;
+    };
+
+    MetricsRegistry() = default;
+    Q_DISABLE_COPY(MetricsRegistry)
+    Series& findOrAdd_(const char* name, const char* help, const QString& labels, Type type);
+
+    mutable QMutex mutex_;                       // registration + render only
+    std::vector<std::unique_ptr<Series>> seriesList_;
+    QHash<QByteArray, Series*> index_;           // name{labels} -> series
+};
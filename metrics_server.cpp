@@ -0,0 +1,60 @@
+#include "metrics_server.h"
+#include "metrics_registry.h"
+
+#include <QCoreApplication>
+#include <QHostAddress>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QThread>
+#include <QDebug>
+
+void MetricsServer::startFromEnv() {
+    bool ok = false;
+    const int port = qEnvironmentVariable("CAMVIGIL_METRICS_PORT").toInt(&ok);
+    if (!ok || port <= 0 || port > 65535) return;
+
+    auto* thread = new QThread();
+    thread->setObjectName("metrics");
+    auto* server = new MetricsServer();
+    server->moveToThread(thread);
+    QObject::connect(thread, &QThread::finished, server, &QObject::deleteLater);
+    QObject::connect(thread, &QThread::finished, thread, &QObject::deleteLater);
+    QObject::connect(qApp, &QCoreApplication::aboutToQuit, thread, [thread]{
+        thread->quit();
+        thread->wait();
+    }, Qt::DirectConnection);
+    thread->start();
+    QMetaObject::invokeMethod(server, "listen", Qt::QueuedConnection, Q_ARG(quint16, quint16(port)));
+}
+
+void MetricsServer::listen(quint16 port) {
+    server_ = new QTcpServer(this);
+    connect(server_, &QTcpServer::newConnection, this, &MetricsServer::onConnection_);
+    if (!server_->listen(QHostAddress::LocalHost, port)) {
+        qWarning() << "[Metrics] listen failed on port" << port << ":" << server_->errorString();
+        return;
+    }
+    qInfo() << "[Metrics] serving on http://127.0.0.1:" << port << "/metrics";
+}
+
+void MetricsServer::onConnection_() {
+    while (QTcpSocket* sock = server_->nextPendingConnection()) {
+        connect(sock, &QTcpSocket::disconnected, sock, &QObject::deleteLater);
+        connect(sock, &QTcpSocket::readyRead, sock, [sock]{
+            // Wait for the end of the request headers; the path is not inspected.
+            if (!sock->peek(sock->bytesAvailable()).contains("\r\n\r\n")) {
+                if (sock->bytesAvailable() > 8192) sock->abort();
+                return;
+            }
+            sock->readAll();
+            const QByteArray body = MetricsRegistry::instance().render();
+            QByteArray resp = "HTTP/1.0 200 OK\r\n"
+                              "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+                              "Content-Length: " + QByteArray::number(body.size()) + "\r\n"
+                              "Connection: close\r\n\r\n";
+            resp += body;
+            sock->write(resp);
+            sock->disconnectFromHost();
+        });
+    }
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include <QObject>
+
+class QTcpServer;
+
+/**
+ * MetricsServer
+ * -------------
+ * Local scrape endpoint for MetricsRegistry (Prometheus text format).
+ * - CAMVIGIL_METRICS_PORT=<port> enables it; bound to 127.0.0.1 only
+ * - any GET answers with the full registry (HTTP/1.0, connection closed)
+ * - runs on its own thread so a busy GUI thread never delays a scrape
+ */
+class MetricsServer : public QObject {
+    Q_OBJECT
+public:
+    // Starts the endpoint if the env var is set; no-op otherwise.
+    static void startFromEnv();
+
+public slots:
+    void listen(quint16 port);
+
+private:
+    explicit MetricsServer(QObject* parent = nullptr) : QObject(parent) {}
+    void onConnection_();
+
+    QTcpServer* server_ = nullptr;
+};
@@ -31,6 +31,20 @@ PlaybackControlsWidget::PlaybackControlsWidget(QWidget* parent)
     dateEdit->setDisplayFormat("dd MMM yyyy");
     connect(dateEdit, &QDateEdit::dateChanged,
             this, &PlaybackControlsWidget::dateChanged);
+    // Snap calendar picks to days with footage
+    if (auto* cal = dateEdit->calendarWidget()) {
+        connect(cal, &QCalendarWidget::clicked, this, [this](const QDate& d){
+            if (!availableDates_.contains(d) && !availableDates_.isEmpty()) {
+                const QDate n = nearestAvailable(d);
+                if (n.isValid()) {
+                    QSignalBlocker b(dateEdit);
+                    dateEdit->setDate(n);
+                }
+            }
+        });
+        connect(cal, &QCalendarWidget::currentPageChanged,
+                this, &PlaybackControlsWidget::formatShownMonth);
+    }
     // Go button
         goBtn = new QPushButton("Go", this);
         goBtn->setCursor(Qt::PointingHandCursor);
@@ -105,36 +119,10 @@ void PlaybackControlsWidget::setAvailableDates(const QSet<QDate>& dates) {
     auto* cal = dateEdit->calendarWidget();
     if (!cal) return;
 
-    // Clear formats
+    // Clear per-date formats, then format only the page on screen
     cal->setDateTextFormat(QDate(), QTextCharFormat{});
+    formatShownMonth(cal->yearShown(), cal->monthShown());
 
-    // Gray-out default for the whole shown range
-    QTextCharFormat gray; gray.setForeground(QBrush(QColor("#666")));
-    const QDate min = dateEdit->minimumDate();
-    const QDate max = dateEdit->maximumDate();
-    for (QDate d = min; d.isValid() && d <= max; d = d.addDays(1)) {
-        cal->setDateTextFormat(d, gray);
-    }
-
-    // Highlight available
-    QTextCharFormat hi;
-    hi.setForeground(Qt::white);
-    hi.setBackground(QColor("#444"));
-    hi.setFontWeight(QFont::Bold);
-    for (const QDate& d : availableDates_) {
-        if (d.isValid()) cal->setDateTextFormat(d, hi);
-    }
-
-    // Enforce selection to available dates
-    connect(cal, &QCalendarWidget::clicked, this, [this](const QDate& d){
-        if (!availableDates_.contains(d) && !availableDates_.isEmpty()) {
-            const QDate n = nearestAvailable(d);
-            if (n.isValid()) {
-                QSignalBlocker b(dateEdit);
-                dateEdit->setDate(n);
-            }
-        }
-    });
     // If current selection is unavailable, snap it
     if (!availableDates_.isEmpty() && !availableDates_.contains(dateEdit->date())) {
         const QDate n = nearestAvailable(dateEdit->date());
@@ -145,6 +133,23 @@ void PlaybackControlsWidget::setAvailableDates(const QSet<QDate>& dates) {
     }
 }
 
+// Grey/highlight the 6x7 grid around one month: cost does not grow with the
+// date range, and weekday formats (which also style the header row) stay untouched.
+void PlaybackControlsWidget::formatShownMonth(int year, int month) {
+    auto* cal = dateEdit->calendarWidget();
+    if (!cal) return;
+    QTextCharFormat gray; gray.setForeground(QBrush(QColor("#666")));
+    QTextCharFormat hi;
+    hi.setForeground(Qt::white);
+    hi.setBackground(QColor("#444"));
+    hi.setFontWeight(QFont::Bold);
+
+    const QDate first(year, month, 1);
+    const QDate start = first.addDays(-7);
+    for (QDate d = start; d < first.addMonths(1).addDays(14); d = d.addDays(1))
+        cal->setDateTextFormat(d, availableDates_.contains(d) ? hi : gray);
+}
+
 QDate PlaybackControlsWidget::nearestAvailable(const QDate& base) const {
     if (availableDates_.isEmpty()) return QDate();
     int bestDiff = std::numeric_limits<int>::max();
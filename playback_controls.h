@@ -31,4 +31,5 @@ private:
     QDateEdit* dateEdit{nullptr};
     QSet<QDate> availableDates_;
     QDate nearestAvailable(const QDate& base) const;
+    void formatShownMonth(int year, int month);   // per-date formats for the visible grid only
 };
@@ -21,7 +21,7 @@ void PlaybackSegmentIndex::build(const SegmentList& segs, qint64 dayStartNs, qin
         return;
     }
 
-    qInfo() << "[SegIndex] build t0=" << t0_ << " t1=" << t1_
+    qDebug() << "[SegIndex] build t0=" << t0_ << " t1=" << t1_
                 << " in.size=" << segs.size();
         int printed = 0;
         // 1) Normalize and clip to the day window
@@ -30,7 +30,7 @@ void PlaybackSegmentIndex::build(const SegmentList& segs, qint64 dayStartNs, qin
         qint64 a = clamp(s.start_ns, t0_, t1_);
         qint64 b = clamp(s.end_ns,   t0_, t1_);
         if (printed < 8) {
-                    qInfo() << "[SegIndex] in start=" << s.start_ns << " end=" << s.end_ns
+                    qDebug() << "[SegIndex] in start=" << s.start_ns << " end=" << s.end_ns
                             << " -> clipped a=" << a << " b=" << b;
                     ++printed;
                 }
@@ -40,7 +40,7 @@ void PlaybackSegmentIndex::build(const SegmentList& segs, qint64 dayStartNs, qin
     }
 
     if (raw.isEmpty()) {
-        qInfo() << "[SegIndex] no segments within day";
+        qDebug() << "[SegIndex] no segments within day";
         return;
     }
 
@@ -149,16 +149,16 @@ void PlaybackSegmentIndex::exportForStitching(QVector<QString>& paths,
 void PlaybackSegmentIndex::debugDump(const char* tag) const
 {
     auto totalSpan = totalSpanNs();
-    qInfo().noquote() << QString("[%1] window %2 .. %3 (span %4 s)")
+    qDebug().noquote() << QString("[%1] window %2 .. %3 (span %4 s)")
         .arg(tag).arg(t0_).arg(t1_).arg(double(totalSpan)/1e9, 0, 'f', 3);
     for (int i=0;i<list_.size();++i){
         const auto& s = list_[i];
-        qInfo().noquote() << QString("  seg[%1]: %2 .. %3  dur=%.3fs  path=%4")
+        qDebug().noquote() << QString("  seg[%1]: %2 .. %3  dur=%.3fs  path=%4")
             .arg(i).arg(s.start_ns).arg(s.end_ns).arg(double(s.duration_ns())/1e9).arg(s.path);
     }
     for (int i=0;i<gaps_.size();++i){
         const auto& g = gaps_[i];
-        qInfo().noquote() << QString("  GAP[%1]: %2 .. %3  dur=%.3fs")
+        qDebug().noquote() << QString("  GAP[%1]: %2 .. %3  dur=%.3fs")
             .arg(i).arg(g.start_ns).arg(g.end_ns).arg(double(g.duration_ns())/1e9);
     }
 }
@@ -20,7 +20,7 @@ void PlaybackStitchingPlayer::attachPlayer(PlaybackVideoPlayerGst* p) {
 }
 
 void PlaybackStitchingPlayer::setPlaylist(QVector<SegmentMeta> metas, qint64 day_start_ns) {
-    qInfo() << "[Stitch] setPlaylist called with" << metas.size() << "segments";
+    qDebug() << "[Stitch] setPlaylist called with" << metas.size() << "segments";
     
     paths_.clear(); wallStarts_.clear(); offsets_.clear(); durations_.clear();
     totalVirt_ = 0; curIdx_ = -1; dayStartNs_ = day_start_ns;
@@ -39,12 +39,12 @@ void PlaybackStitchingPlayer::setPlaylist(QVector<SegmentMeta> metas, qint64 day
         totalVirt_  = qMax(totalVirt_, m.offset_ns + m.duration_ns);
     }
     
-    qInfo() << "[Stitch] Playlist set - segments:" << paths_.size() 
+    qDebug() << "[Stitch] Playlist set - segments:" << paths_.size() 
             << "total duration:" << (totalVirt_ / 1e9) << "seconds";
 }
 
 void PlaybackStitchingPlayer::play() {
-    qInfo() << "[Stitch] play() called - hasPlaylist:" << hasPlaylist() 
+    qDebug() << "[Stitch] play() called - hasPlaylist:" << hasPlaylist() 
             << "isPlaying:" << isPlaying_;
     
     if (!hasPlaylist()) {
@@ -60,10 +60,10 @@ void PlaybackStitchingPlayer::play() {
 }
 
 void PlaybackStitchingPlayer::pause() {
-    qInfo() << "[Stitch] pause() called - isPlaying:" << isPlaying_;
+    qDebug() << "[Stitch] pause() called - isPlaying:" << isPlaying_;
     
     if (!isPlaying_) {
-        qInfo() << "[Stitch] Not playing, ignoring pause command";
+        qDebug() << "[Stitch] Not playing, ignoring pause command";
         return;
     }
     
@@ -73,7 +73,7 @@ void PlaybackStitchingPlayer::pause() {
 }
 
 void PlaybackStitchingPlayer::stop() {
-    qInfo() << "[Stitch] stop() called";
+    qDebug() << "[Stitch] stop() called";
     playerStop();
     curIdx_ = -1;
     isPlaying_ = false;
@@ -86,7 +86,7 @@ void PlaybackStitchingPlayer::setRate(double r) {
 }
 
 void PlaybackStitchingPlayer::playAtVirtual(qint64 virt_ns) {
-    qInfo() << "[Stitch] playAtVirtual called with virt_ns:" << virt_ns;
+    qDebug() << "[Stitch] playAtVirtual called with virt_ns:" << virt_ns;
     
     if (paths_.isEmpty() || !player_) {
         qWarning() << "[Stitch] Cannot play: paths_.isEmpty()" << paths_.isEmpty() 
@@ -104,7 +104,7 @@ void PlaybackStitchingPlayer::playAtVirtual(qint64 virt_ns) {
         return;
     }
 
-    qInfo() << "[Stitch] Opening segment" << idx << "at position" << inSeg;
+    qDebug() << "[Stitch] Opening segment" << idx << "at position" << inSeg;
     if (idx != curIdx_) openIndex(idx);
     playerSeek(inSeg);
     playerPlay();
@@ -136,18 +136,18 @@ OPEN:
 }
 
 void PlaybackStitchingPlayer::onPlayerEos() {
-    qInfo() << "[Stitch] onPlayerEos - current segment:" << curIdx_ 
+    qDebug() << "[Stitch] onPlayerEos - current segment:" << curIdx_ 
             << "total segments:" << paths_.size();
     
     const int next = curIdx_ + 1;
     if (next >= 0 && next < paths_.size()) {
-        qInfo() << "[Stitch] Moving to next segment:" << next;
+        qDebug() << "[Stitch] Moving to next segment:" << next;
         openIndex(next);
         playerSeek(0);
         playerPlay();
         // Keep isPlaying_ = true since we're continuing to next segment
     } else {
-        qInfo() << "[Stitch] Reached end of playlist";
+        qDebug() << "[Stitch] Reached end of playlist";
         isPlaying_ = false;
         emit stateChanged(false);
         emit reachedEnd();
@@ -1,4 +1,5 @@
 #include "playback_timeline_controller.h"
+#include "coverage_spans.h"
 #include <QDateTime>
 
 static inline qint64 toNs(qint64 s){ return s*1000000000LL; }
@@ -13,8 +14,8 @@ void PlaybackTimelineController::attach(DbReader* r){
         if (db_) QObject::disconnect(db_, nullptr, this, nullptr);
         db_ = r;
         if (db_) {
-            connect(db_, &DbReader::segmentsReady,
-                    this, &PlaybackTimelineController::onSegmentsReady,
+            connect(db_, &DbReader::coverageReady,
+                    this, &PlaybackTimelineController::onCoverageReady,
                     Qt::QueuedConnection);
             emit log(QString("[Ctl] attached DbReader=%1")
                      .arg(reinterpret_cast<quintptr>(db_), 0, 16));
@@ -38,16 +39,19 @@ void PlaybackTimelineController::onGo(const QString& camName, const QDate& day){
     }
     pendingCid_ = cid; pendingDay_ = day;
     emit log(QString("[Go] cid=%1 day=%2").arg(cid).arg(day.toString("yyyy-MM-dd")));
+    // Bar from the precomputed camera_coverage row; segments still feed the stitch playlist.
+    QMetaObject::invokeMethod(db_, "listCoverage", Qt::QueuedConnection,
+                              Q_ARG(int, cid),
+                              Q_ARG(QString, day.toString("yyyy-MM-dd")));
     QMetaObject::invokeMethod(db_, "listSegments", Qt::QueuedConnection,
                               Q_ARG(int, cid),
                               Q_ARG(QString, day.toString("yyyy-MM-dd")));
 }
 
-void PlaybackTimelineController::onSegmentsReady(int cameraId, const SegmentList& segs){
-    if (cameraId != pendingCid_) return;
-    QVector<TimelineSpan> raw; raw.reserve(segs.size());
-    for (const auto& s: segs) raw.push_back({s.start_ns, s.end_ns});
-    model_.build(dayStartNs(pendingDay_), dayEndNs(pendingDay_), raw);
+void PlaybackTimelineController::onCoverageReady(int cameraId, const QString& ymd, const QByteArray& spans){
+    if (cameraId != pendingCid_ || ymd != pendingDay_.toString("yyyy-MM-dd")) return;
+    model_.buildFromCoverage(dayStartNs(pendingDay_), dayEndNs(pendingDay_),
+                             CoverageSpans::fromBlob(spans));
     emit built(pendingDay_, model_);
     emit log(QString("[Timeline] built spans=%1 covered_s=%2")
              .arg(model_.spans().size())
@@ -16,7 +16,7 @@ signals:
     void log(const QString& msg);
 public slots:
     void onGo(const QString& camName, const QDate& day);
-    void onSegmentsReady(int cameraId, const SegmentList& segs);
+    void onCoverageReady(int cameraId, const QString& ymd, const QByteArray& spans);
 private:
     DbReader* db_{nullptr};
     std::function<int(const QString&)> resolveCamId_;
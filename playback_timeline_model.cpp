@@ -1,4 +1,5 @@
 #include "playback_timeline_model.h"
+#include "coverage_spans.h"
 #include <algorithm>
 
 static inline TimelineSpan clip(const TimelineSpan& s, qint64 a, qint64 b) {
@@ -9,7 +10,7 @@ static inline TimelineSpan clip(const TimelineSpan& s, qint64 a, qint64 b) {
 
 void PlaybackTimelineModel::build(qint64 dayStartNs, qint64 dayEndNs,
                                   const QVector<TimelineSpan>& raw) {
-    t0_ = dayStartNs; t1_ = dayEndNs; spans_.clear();
+    t0_ = dayStartNs; t1_ = dayEndNs; spans_.clear(); covered_ = 0;
 
     // 1) Clip-by-day and drop outside
     QVector<TimelineSpan> v; v.reserve(raw.size());
@@ -45,6 +46,28 @@ void PlaybackTimelineModel::build(qint64 dayStartNs, qint64 dayEndNs,
             spans_.last().end_ns = std::max(spans_.last().end_ns, s.end_ns);
         }
     }
+    for (const auto& s : spans_) covered_ += s.end_ns - s.start_ns;
+}
+
+void PlaybackTimelineModel::buildFromCoverage(qint64 dayStartNs, qint64 dayEndNs,
+                                              const CoverageSpans& coverage) {
+    t0_ = dayStartNs; t1_ = dayEndNs; spans_.clear(); covered_ = 0;
+    spans_.reserve(coverage.runs().size());
+    for (const auto& r : coverage.runs()) {
+        const TimelineSpan s = clip({ dayStartNs + r.start * 1000000000LL,
+                                      dayStartNs + r.end * 1000000000LL }, dayStartNs, dayEndNs);
+        if (s.end_ns <= s.start_ns) continue;
+        spans_.push_back(s);
+        covered_ += s.end_ns - s.start_ns;
+    }
+}
+
+bool PlaybackTimelineModel::coveredAt(qint64 t_ns) const {
+    auto it = std::upper_bound(spans_.cbegin(), spans_.cend(), t_ns,
+                               [](qint64 t, const TimelineSpan& s){ return t < s.start_ns; });
+    if (it == spans_.cbegin()) return false;
+    --it;
+    return t_ns < it->end_ns;
 }
 
 
@@ -55,8 +78,3 @@ qreal PlaybackTimelineModel::fractionFor(qint64 t_ns) const {
     return qreal(t_ns - t0_) / qreal(t1_ - t0_);
 }
 
-qint64 PlaybackTimelineModel::totalCoveredNs() const {
-    qint64 sum = 0;
-    for (const auto& s : spans_) sum += std::max<qint64>(0, s.end_ns - s.start_ns);
-    return sum;
-}
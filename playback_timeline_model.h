@@ -2,6 +2,8 @@
 #include <QVector>
 #include <QString>
 
+class CoverageSpans;
+
 struct TimelineSpan {
     qint64 start_ns{0};
     qint64 end_ns{0};
@@ -11,10 +13,16 @@ class PlaybackTimelineModel {
 public:
     void build(qint64 dayStartNs, qint64 dayEndNs,
                const QVector<TimelineSpan>& rawSegments);
+    // Precomputed runs are already sorted and disjoint: no sort/merge pass.
+    void buildFromCoverage(qint64 dayStartNs, qint64 dayEndNs,
+                           const CoverageSpans& coverage);
     const QVector<TimelineSpan>& spans() const { return spans_; }
+    qint64 dayStartNs() const { return t0_; }
     qreal fractionFor(qint64 t_ns) const; // 0..1 position helper
-    qint64 totalCoveredNs() const;
+    bool coveredAt(qint64 t_ns) const;    // binary search over spans_
+    qint64 totalCoveredNs() const { return covered_; }
 private:
     QVector<TimelineSpan> spans_;
     qint64 t0_{0}, t1_{0};
+    qint64 covered_{0};
 };
@@ -13,6 +13,7 @@ setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
 
 void PlaybackTimelineView::setModel(const PlaybackTimelineModel* m) {
 model_ = m;
+pixelRunsWidth_ = -1;
 update();
 }
 
@@ -27,6 +28,23 @@ update();
 QRect PlaybackTimelineView::barRect() const {
 return rect().adjusted(16, 16, -16, -24);
 }
+
+const QVector<QPair<int,int>>& PlaybackTimelineView::pixelRunsFor_(const QRect& r) const {
+if (pixelRunsWidth_ == r.width()) return pixelRuns_;
+pixelRunsWidth_ = r.width();
+pixelRuns_.clear();
+if (!model_) return pixelRuns_;
+// x offsets from r.left(); spans closer than a pixel collapse into one run
+for (const auto& s : model_->spans()) {
+    const int x1 = int(model_->fractionFor(s.start_ns) * r.width());
+    const int x2 = qMax(x1 + 2, int(model_->fractionFor(s.end_ns) * r.width()));
+    if (!pixelRuns_.isEmpty() && x1 <= pixelRuns_.last().second)
+        pixelRuns_.last().second = qMax(pixelRuns_.last().second, x2);
+    else
+        pixelRuns_.push_back({x1, x2});
+}
+return pixelRuns_;
+}
 // trim selection
 // -------
 qint64 PlaybackTimelineView::posToNs_(int x, const QRect& r) const {
@@ -88,12 +106,8 @@ for (int h=0; h<=24; ++h) {
 
 if (model_) {
     p.setPen(Qt::NoPen);
-    for (const auto& s : model_->spans()) {
-        const qreal fx1 = model_->fractionFor(s.start_ns);
-        const qreal fx2 = model_->fractionFor(s.end_ns);
-        const int x1 = int(r.left() + fx1 * r.width());
-        const int x2 = int(r.left() + fx2 * r.width());
-        QRect seg(x1, r.top()+4, qMax(2, x2-x1), r.height()-8);
+    for (const auto& run : pixelRunsFor_(r)) {
+        QRect seg(r.left() + run.first, r.top()+4, run.second - run.first, r.height()-8);
         p.fillRect(seg, QColor("#3ddc84"));
         p.setPen(QColor("#2aa864")); p.drawRect(seg.adjusted(0,0,-1,-1));
         p.setPen(Qt::NoPen);
@@ -140,7 +154,9 @@ const qint64 t_ns = posToNs_(e->pos().x(), r);
 const qreal fx = qBound<qreal>(0.0, t_ns / (qreal)dayNs_(), 1.0);
 const int hh = int(fx * 24.0);
 const int mm = int(fmod(fx*24.0, 1.0) * 60.0);
-setToolTip(QString("%1:%2").arg(hh,2,10,QChar('0')).arg(mm,2,10,QChar('0')));
+QString tip = QString("%1:%2").arg(hh,2,10,QChar('0')).arg(mm,2,10,QChar('0'));
+if (model_ && !model_->coveredAt(model_->dayStartNs() + t_ns)) tip += " (no recording)";
+setToolTip(tip);
 
 emit hoverTimeNs(t_ns);
 
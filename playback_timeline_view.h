@@ -1,6 +1,8 @@
 #pragma once
 #include <QWidget>
 #include <QElapsedTimer>
+#include <QPair>
+#include <QVector>
 #include "playback_timeline_model.h"
 
 class PlaybackTimelineView : public QWidget {
@@ -32,6 +34,10 @@ private:
 const PlaybackTimelineModel* model_{nullptr};
 QRect  barRect() const;
 qint64 dayNs_() const { return 24LL*3600LL*1000000000LL; }
+// Spans merged to pixel columns; rebuilt on setModel() or a bar width change
+const QVector<QPair<int,int>>& pixelRunsFor_(const QRect& bar) const;
+mutable QVector<QPair<int,int>> pixelRuns_;
+mutable int pixelRunsWidth_ = -1;
 
 qint64       playheadNs_ = 0;
 bool         dragging_   = false;
@@ -2,6 +2,8 @@
 #include <QTimer>
 #include <QDebug>
 #include <gst/video/videooverlay.h>
+#include "gst_bus_dispatcher.h"
+#include "metrics_registry.h"
 
 static inline GstElement* mk(const char* f){ return gst_element_factory_make(f,nullptr); }
 
@@ -16,14 +18,11 @@ PlaybackVideoPlayerGst::PlaybackVideoPlayerGst(QObject* parent)
 {
     ensure_gst_init();
     posTimer = nullptr;
-    busTimer = nullptr;
-    bus = nullptr;
 }
 
 PlaybackVideoPlayerGst::~PlaybackVideoPlayerGst() {
     teardown();
     if (posTimer) posTimer->stop();
-    if (busTimer) busTimer->stop();
 }
 
 void PlaybackVideoPlayerGst::setWindowHandle(quintptr wid) {
@@ -32,7 +31,7 @@ void PlaybackVideoPlayerGst::setWindowHandle(quintptr wid) {
 }
 
 bool PlaybackVideoPlayerGst::open(const QString& path) {
-    qInfo() << "[Player] Opening file:" << path;
+    qDebug() << "[Player] Opening file:" << path;
 
     // First-time pipeline build
     if (!pipeline) {
@@ -100,33 +99,10 @@ bool PlaybackVideoPlayerGst::open(const QString& path) {
                 gst_object_unref(sinkPad);
             }), this);
 
-        // Bus polling on the Qt thread (no GLib loop)
-        bus = gst_element_get_bus(pipeline);
-        if (!busTimer) {
-            busTimer = new QTimer(this);
-            connect(busTimer, &QTimer::timeout, this, [this]{
-                if (!pipeline || !bus) return;
-                while (GstMessage* msg = gst_bus_pop_filtered(
-                           bus, (GstMessageType)(GST_MESSAGE_ERROR | GST_MESSAGE_EOS))) {
-                    switch (GST_MESSAGE_TYPE(msg)) {
-                    case GST_MESSAGE_ERROR: {
-                        GError* err=nullptr; gchar* dbg=nullptr;
-                        gst_message_parse_error(msg, &err, &dbg);
-                        emit errorText(QString::fromUtf8(err ? err->message : "GStreamer error"));
-                        if (dbg) qWarning("GST DEBUG: %s", dbg);
-                        g_clear_error(&err); g_free(dbg);
-                        break;
-                    }
-                    case GST_MESSAGE_EOS:
-                        emit eos();
-                        break;
-                    default: break;
-                    }
-                    gst_message_unref(msg);
-                }
-            });
-        }
-        if (!busTimer->isActive()) busTimer->start(50);
+        // ERROR/EOS arrive on the shared dispatcher thread; signals queue back to us
+        busWatch = GstBusDispatcher::instance().watch(pipeline, [this](GstMessage* msg){
+            bus_cb(nullptr, msg, this);
+        });
 
         // Bind overlay once
         bindOverlay();
@@ -157,7 +133,7 @@ bool PlaybackVideoPlayerGst::open(const QString& path) {
 
 void PlaybackVideoPlayerGst::play()  {
     if (pipeline) {
-        qInfo() << "[Player] Starting playback";
+        qDebug() << "[Player] Starting playback";
         gst_element_set_state(pipeline, GST_STATE_PLAYING);
     } else {
         qWarning() << "[Player] Cannot play: pipeline is null";
@@ -165,7 +141,7 @@ void PlaybackVideoPlayerGst::play()  {
 }
 void PlaybackVideoPlayerGst::pause() {
     if (pipeline) {
-        qInfo() << "[Player] Pausing playback";
+        qDebug() << "[Player] Pausing playback";
         gst_element_set_state(pipeline, GST_STATE_PAUSED);
     } else {
         qWarning() << "[Player] Cannot pause: pipeline is null";
@@ -173,7 +149,7 @@ void PlaybackVideoPlayerGst::pause() {
 }
 void PlaybackVideoPlayerGst::stop()  {
     if (pipeline) {
-        qInfo() << "[Player] Stopping playback";
+        qDebug() << "[Player] Stopping playback";
         gst_element_set_state(pipeline, GST_STATE_NULL);
     } else {
         qWarning() << "[Player] Cannot stop: pipeline is null";
@@ -182,6 +158,7 @@ void PlaybackVideoPlayerGst::stop()  {
 
 bool PlaybackVideoPlayerGst::seekNs(qint64 t_ns) {
     if (!pipeline) return false;
+    seekStartUs.store(g_get_monotonic_time());
     // Interactive seeks: fast, keyframe-based, flushing
     gboolean ok = gst_element_seek(pipeline, rate_, GST_FORMAT_TIME,
         (GstSeekFlags)(GST_SEEK_FLAG_FLUSH | GST_SEEK_FLAG_KEY_UNIT | GST_SEEK_FLAG_SNAP_NEAREST),
@@ -210,13 +187,13 @@ void PlaybackVideoPlayerGst::bindOverlay() {
 }
 
 void PlaybackVideoPlayerGst::teardown() {
+    GstBusDispatcher::instance().unwatch(busWatch);
+    busWatch = 0;
     if (pipeline) {
         gst_element_set_state(pipeline, GST_STATE_NULL);
         gst_object_unref(pipeline);
         pipeline = nullptr;
     }
-    if (busTimer) busTimer->stop();
-    if (bus) { gst_object_unref(bus); bus = nullptr; }
     filesrc = demux = parser = decoder = queue_demux = queue_post = vconv = videosink = nullptr;
     if (posTimer && posTimer->isActive()) posTimer->stop();
     stop();
@@ -228,7 +205,7 @@ gboolean PlaybackVideoPlayerGst::bus_cb(GstBus*, GstMessage* msg, gpointer s) {
     case GST_MESSAGE_ERROR: {
         GError* err=nullptr; gchar* dbg=nullptr;
         gst_message_parse_error(msg, &err, &dbg);
-        if (self) self->errorText(QString::fromUtf8(err ? err->message : "GStreamer error"));
+        if (self) emit self->errorText(QString::fromUtf8(err ? err->message : "GStreamer error"));
         if (dbg) qWarning("GST DEBUG: %s", dbg);
         g_clear_error(&err); g_free(dbg);
         break;
@@ -236,6 +213,17 @@ gboolean PlaybackVideoPlayerGst::bus_cb(GstBus*, GstMessage* msg, gpointer s) {
     case GST_MESSAGE_EOS:
         if (self) emit self->eos();
         break;
+    case GST_MESSAGE_ASYNC_DONE: {
+        // Flushing seek settled (prerolled at the new position)
+        if (!self || GST_MESSAGE_SRC(msg) != GST_OBJECT(self->pipeline)) break;
+        const qint64 t0 = self->seekStartUs.exchange(0);
+        if (t0 > 0) {
+            static MetricHistogram& h = MetricsRegistry::instance().histogram(
+                "camvigil_playback_seek_seconds", "Playback seek to ASYNC_DONE latency");
+            h.observeUs(g_get_monotonic_time() - t0);
+        }
+        break;
+    }
     default: break;
     }
     return TRUE;
@@ -3,6 +3,7 @@
 #include <QString>
 #include <QTimer>
 #include <QtGlobal>
+#include <atomic>
 #include <gst/gst.h>
 
 class QTimer;
@@ -58,7 +59,7 @@ private:
     GstElement* videosink     = nullptr;
     quintptr    winHandle     = 0;
     double      rate_         = 1.0;
-    QTimer* busTimer = nullptr;
-    GstBus* bus = nullptr;
+    guint       busWatch      = 0;   // GstBusDispatcher token
+    std::atomic<qint64> seekStartUs{0};  // pending flush seek -> ASYNC_DONE (camvigil_playback_seek_seconds)
 };
 Q_DECLARE_METATYPE(PlaybackVideoPlayerGst*)
@@ -0,0 +1,42 @@
+#pragma once
+#include <QJsonObject>
+#include <QtGlobal>
+
+/**
+ * RetentionPolicy
+ * ---------------
+ * Per-camera retention knobs, stored as an optional "retention" object on the
+ * camera entry in cameras.json:
+ *   { "quota_gb": 200, "min_days": 3, "max_days": 30, "weight": 2.0 }
+ * - quota_gb : purge this camera's oldest footage above this size (0 = none)
+ * - min_days : never purge footage younger than this, even under disk pressure
+ * - max_days : purge anything older than this regardless of free space (0 = none)
+ * - weight   : share of the disk under pressure; 2.0 keeps twice the bytes of 1.0
+ * Unset fields fall back to CAMVIGIL_RETENTION_MIN_DAYS / CAMVIGIL_RETENTION_MAX_DAYS.
+ */
+struct RetentionPolicy {
+    qint64 quotaBytes = 0;
+    int    minDays    = -1;    // -1 = global default
+    int    maxDays    = -1;    // -1 = global default
+    double weight     = 1.0;
+
+    bool isDefault() const { return quotaBytes <= 0 && minDays < 0 && maxDays < 0 && qFuzzyCompare(weight, 1.0); }
+
+    static RetentionPolicy fromJson(const QJsonObject& o) {
+        RetentionPolicy p;
+        p.quotaBytes = qint64(qMax(0.0, o.value("quota_gb").toDouble(0)) * 1024.0 * 1024.0 * 1024.0);
+        p.minDays    = o.contains("min_days") ? qMax(0, o.value("min_days").toInt()) : -1;
+        p.maxDays    = o.contains("max_days") ? qMax(0, o.value("max_days").toInt()) : -1;
+        p.weight     = qMax(0.01, o.value("weight").toDouble(1.0));
+        return p;
+    }
+
+    QJsonObject toJson() const {
+        QJsonObject o;
+        if (quotaBytes > 0) o["quota_gb"] = double(quotaBytes) / (1024.0 * 1024.0 * 1024.0);
+        if (minDays >= 0)   o["min_days"] = minDays;
+        if (maxDays >= 0)   o["max_days"] = maxDays;
+        if (!qFuzzyCompare(weight, 1.0)) o["weight"] = weight;
+        return o;
+    }
+};
@@ -0,0 +1,278 @@
+#include "retention_service.h"
+
+#include <QDir>
+#include <QDateTime>
+#include <QSet>
+#include <QFile>
+#include <QDebug>
+#include <QStorageInfo>
+#include <QThread>
+#include <QTimer>
+#include <QtGlobal>
+#include <limits>
+
+#include "db_writer.h"
+#include "metrics_registry.h"
+#include "segment_file_pool.h"
+#include "storage_ledger.h"
+
+RetentionService::RetentionService(const QString& archiveDir, DbWriter* db, SegmentFilePool* pool,
+                                   StorageLedger* ledger)
+    : archiveDir_(archiveDir), db_(db), pool_(pool), ledger_(ledger)
+{
+    rcfg_.perCameraMinDays = qMax(0, qEnvironmentVariable("CAMVIGIL_RETENTION_MIN_DAYS").toInt());
+    rcfg_.perCameraMaxDays = qMax(0, qEnvironmentVariable("CAMVIGIL_RETENTION_MAX_DAYS").toInt());
+}
+
+void RetentionService::start()
+{
+    // Timer: refresh watermarks then purge check
+    periodic_ = new QTimer(this);
+    connect(periodic_, &QTimer::timeout, this, [this]{
+        refreshWatermarks_();
+        runPurge_();
+    });
+    periodic_->start(kPeriodMs);
+
+    // Finalized segments from every camera collapse into one pass
+    debounce_ = new QTimer(this);
+    debounce_->setSingleShot(true);
+    debounce_->setInterval(kDebounceMs);
+    connect(debounce_, &QTimer::timeout, this, &RetentionService::runPurge_);
+
+    // Ledger drift (open segments, foreign files) is absorbed here
+    reconcile_ = new QTimer(this);
+    connect(reconcile_, &QTimer::timeout, this, &RetentionService::reconcileLedger);
+    reconcile_->start(kReconcileMs);
+
+    reconcileLedger();
+    refreshWatermarks_();
+    runPurge_();
+    qDebug() << "[Retention] service started for" << archiveDir_;
+}
+
+void RetentionService::requestPurge()
+{
+    if (debounce_ && !debounce_->isActive()) debounce_->start();
+}
+
+void RetentionService::reconcileLedger()
+{
+    if (!db_ || !ledger_) return;
+    bool reconciled = false;
+    // statfs, the aggregate and reconcile() all run on the DB thread, which is
+    // the only writer of ledger deltas: nothing can land between them.
+    const bool ok = QMetaObject::invokeMethod(db_, [&]{
+        QHash<int, QString> names;
+        QHash<StorageLedger::SegmentKey, qint64> open;
+        const QVector<StorageLedger::Usage> rows = db_->finalizedUsage(&names, &open);
+        idsByUrl_ = db_->cameraIdsByUrl();
+        QStorageInfo si(archiveDir_);
+        if (!si.isValid() || si.bytesTotal() <= 0) return;
+        // Pooled slots still hold their blocks but are space the next segments reuse.
+        const qint64 pooled = pool_ ? pool_->pooledBytes() : 0;
+        ledger_->reconcile(si.bytesTotal(), si.bytesAvailable() + pooled, rows, names, open);
+        reconciled = true;
+    }, Qt::BlockingQueuedConnection);
+    if (!ok || !reconciled) return;
+    resolvePolicies_();   // picks up cameras registered since the last pass
+}
+
+void RetentionService::setPolicies(const QHash<QString, RetentionPolicy>& byUrl)
+{
+    policiesByUrl_ = byUrl;
+    resolvePolicies_();
+}
+
+void RetentionService::resolvePolicies_()
+{
+    policyById_.clear();
+    for (auto it = policiesByUrl_.cbegin(); it != policiesByUrl_.cend(); ++it)
+        if (idsByUrl_.contains(it.key())) policyById_.insert(idsByUrl_.value(it.key()), it.value());
+}
+
+RetentionPolicy RetentionService::policyFor_(int cameraId) const
+{
+    RetentionPolicy p = policyById_.value(cameraId);
+    if (p.minDays < 0) p.minDays = rcfg_.perCameraMinDays;
+    if (p.maxDays < 0) p.maxDays = rcfg_.perCameraMaxDays;
+    return p;
+}
+
+// ---------- Dynamic watermarks ----------
+
+static double envPct(const char* name, double fallbackPct)
+{
+    bool ok=false;
+    const QString s = qEnvironmentVariable(name);
+    if (!s.isEmpty()) {
+        const double v = s.toDouble(&ok);
+        if (ok) return qBound(0.0, v/100.0, 0.95); // 72 -> 0.72
+    }
+    return qBound(0.0, fallbackPct/100.0, 0.95);    // << divide fallback too
+}
+
+void RetentionService::refreshWatermarks_()
+{
+    if (!ledger_->isValid() || ledger_->totalBytes() <= 0) return;
+
+    const qint64 total = ledger_->totalBytes();
+
+    // Defaults: start at 10% free, recover to 12% free. Overridable via env.
+    const double minPct    = envPct("CAMVIGIL_MIN_FREE_PCT",    70.0);
+    const double targetPct = envPct("CAMVIGIL_TARGET_FREE_PCT", 72.0);
+
+    rcfg_.minFreeBytes    = static_cast<qint64>(total * minPct);
+    rcfg_.targetFreeBytes = static_cast<qint64>(total * targetPct);
+    rcfg_.highWaterPct    = 90; // 90% used is an alternate trigger
+
+    qInfo() << "[Purge] watermarks set:"
+            << "total=" << total
+            << "minFreeBytes=" << rcfg_.minFreeBytes
+            << "targetFreeBytes=" << rcfg_.targetFreeBytes
+            << "highWater%=" << rcfg_.highWaterPct;
+}
+
+// ---------- Ring-buffer helpers ----------
+
+bool RetentionService::shouldPurge_(qint64& needBytes, qint64& availBytes)
+{
+    if (!ledger_->isValid()) return false;
+    const qint64 total = ledger_->totalBytes();
+    availBytes = ledger_->freeBytes();
+    if (total <= 0) return false;
+    const int usedPct = int((total - availBytes) * 100 / total);
+
+    const bool trigger = (availBytes < rcfg_.minFreeBytes) || (usedPct >= rcfg_.highWaterPct);
+    qDebug() << "[Purge] check avail=" << availBytes
+            << "total=" << total
+            << "used%=" << usedPct
+            << "minFree=" << rcfg_.minFreeBytes
+            << "targetFree=" << rcfg_.targetFreeBytes
+            << "trigger=" << trigger;
+
+    if (trigger) {
+        needBytes = qMax<qint64>(rcfg_.targetFreeBytes - availBytes, 0);
+        return needBytes > 0;
+    }
+    return false;
+}
+
+qint64 RetentionService::purgeBatch_(int cameraId, qint64 beforeUtcNs, int& removed)
+{
+    removed = 0;
+    QVector<QPair<qint64, QString>> victims;
+    const bool okFetch = QMetaObject::invokeMethod(
+        db_, [&]{ victims = db_->purgeCandidates(cameraId, beforeUtcNs, rcfg_.purgeBatchFiles); },
+        Qt::BlockingQueuedConnection);
+    if (!okFetch || victims.isEmpty()) return 0;
+
+    QVector<qint64> ids;
+    ids.reserve(victims.size());
+    for (const auto& v : victims) {
+        const QString& path = v.second;
+        QFile f(path);
+        // Recycling keeps the inode for the next segment; full pool falls back to unlink.
+        bool ok = !f.exists() || (pool_ && pool_->recycle(path)) || f.remove();
+        if (!ok) { QThread::msleep(50); ok = !f.exists() || f.remove(); }
+        if (!ok) { qWarning() << "[Purge] unlink failed:" << path; continue; }
+        ids.push_back(v.first);
+    }
+
+    qint64 freed = 0;
+    QMetaObject::invokeMethod(db_, [&]{ freed = db_->deleteSegmentRows(ids); },
+                              Qt::BlockingQueuedConnection);
+    if (freed < 0) { qWarning() << "[Purge] DB batch delete failed, rows=" << ids.size(); return -1; }
+
+    removed = ids.size();
+    static MetricCounter& purgedBytes = MetricsRegistry::instance().counter(
+        "camvigil_purge_bytes_total", "Archive bytes released by retention");
+    static MetricCounter& purgedFiles = MetricsRegistry::instance().counter(
+        "camvigil_purge_files_total", "Segment files removed by retention");
+    purgedBytes.inc(quint64(freed));
+    purgedFiles.inc(quint64(removed));
+    qDebug() << "[Purge] batch cam=" << cameraId << "candidates=" << victims.size()
+            << "removed=" << removed << "freed=" << freed;
+    return freed;
+}
+
+bool RetentionService::drain_(int cameraId, qint64 beforeUtcNs, const std::function<bool()>& more,
+                              qint64& freed, int& files)
+{
+    while (more()) {
+        if (QThread::currentThread()->isInterruptionRequested()) return false;
+        int removed = 0;
+        const qint64 batch = purgeBatch_(cameraId, beforeUtcNs, removed);
+        if (batch < 0 || removed == 0) return false;
+        freed += batch;
+        files += removed;
+        emit purgeProgress(freed, files);
+    }
+    return true;
+}
+
+// ---------- Purge pass ----------
+
+void RetentionService::runPurge_()
+{
+    if (!db_ || !ledger_ || !ledger_->isValid() || archiveDir_.isEmpty() || !QDir(archiveDir_).exists()) return;
+
+    const qint64 dayNs = 86400LL * 1000000000LL;
+    const qint64 nowNs = QDateTime::currentDateTimeUtc().toMSecsSinceEpoch() * 1000000LL;
+    auto cutoff = [&](int days) { return days > 0 ? nowNs - days * dayNs : std::numeric_limits<qint64>::max(); };
+    const auto always = []{ return true; };
+
+    qint64 totalFreed = 0;
+    int    totalFiles = 0;
+    const QList<int> cams = ledger_->perCamera().keys();
+
+    // 1) Time limits: anything past max-days goes, free space or not.
+    for (int cam : cams) {
+        const RetentionPolicy p = policyFor_(cam);
+        if (p.maxDays > 0) drain_(cam, cutoff(p.maxDays), always, totalFreed, totalFiles);
+    }
+
+    // 2) Byte quotas: trim cameras over their own budget, oldest first.
+    for (int cam : cams) {
+        const RetentionPolicy p = policyFor_(cam);
+        if (p.quotaBytes <= 0) continue;
+        drain_(cam, cutoff(p.minDays), [&]{ return ledger_->cameraBytes(cam) > p.quotaBytes; },
+               totalFreed, totalFiles);
+    }
+
+    // 3) Disk pressure: take from whichever camera holds the most bytes per unit of
+    //    weight, one batch at a time, so a noisy camera can't evict the quiet ones.
+    qint64 need=0, avail=0;
+    if (shouldPurge_(need, avail)) {
+        emit purgeStarted(need);
+        QSet<int> exhausted;
+        while (ledger_->freeBytes() < rcfg_.targetFreeBytes &&
+               !QThread::currentThread()->isInterruptionRequested()) {
+            int pick = -1;
+            double best = -1.0;
+            const QHash<int, qint64> usage = ledger_->perCamera();
+            for (auto it = usage.cbegin(); it != usage.cend(); ++it) {
+                if (exhausted.contains(it.key()) || it.value() <= 0) continue;
+                const double score = double(it.value()) / policyFor_(it.key()).weight;
+                if (score > best) { best = score; pick = it.key(); }
+            }
+            if (pick < 0) break;
+
+            int removed = 0;
+            const qint64 freed = purgeBatch_(pick, cutoff(policyFor_(pick).minDays), removed);
+            if (freed < 0) break;
+            if (removed == 0) { exhausted.insert(pick); continue; }
+            totalFreed += freed;
+            totalFiles += removed;
+            emit purgeProgress(totalFreed, totalFiles);
+        }
+        if (ledger_->freeBytes() < rcfg_.targetFreeBytes)
+            qWarning() << "[Purge] target not reached; remaining footage is inside min-days or pinned";
+    }
+
+    if (totalFiles == 0) return;
+    qInfo() << "[Purge] exit freed_total=" << totalFreed
+            << "files=" << totalFiles
+            << "free_now=" << ledger_->freeBytes();
+    emit purgeFinished(totalFreed, totalFiles);
+}
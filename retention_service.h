@@ -0,0 +1,86 @@
+#pragma once
+#include <QObject>
+#include <QString>
+#include <QHash>
+#include <functional>
+#include "retention_policy.h"
+
+class DbWriter;
+class SegmentFilePool;
+class StorageLedger;
+class QTimer;
+
+// Dynamic, size-based ring buffer config.
+// minFreeBytes/targetFreeBytes are computed from total capacity by refreshWatermarks().
+// Override percentages via env:
+//   CAMVIGIL_MIN_FREE_PCT    (default 10)
+//   CAMVIGIL_TARGET_FREE_PCT (default 12)
+struct RetentionCfg {
+    qint64 minFreeBytes     = 0;   // computed each refresh
+    qint64 targetFreeBytes  = 0;   // computed each refresh
+    int    highWaterPct     = 90;  // purge if used% >= this
+    int    purgeBatchFiles  = 64;  // delete in batches
+    int    perCameraMinDays = 0;   // keep N days per camera (0=off), CAMVIGIL_RETENTION_MIN_DAYS
+    int    perCameraMaxDays = 0;   // drop after N days (0=off), CAMVIGIL_RETENTION_MAX_DAYS
+};
+
+/**
+ * RetentionService
+ * ----------------
+ * Ring-buffer purge on its own thread (owned by ArchiveManager).
+ * - own scheduler: periodic watermark refresh + purge check, and a short
+ *   debounce so a burst of finalized segments triggers one pass
+ * - decisions read the StorageLedger (O(1)); the ledger is reconciled here
+ *   once a minute from one statfs + one DB aggregate, never per file
+ * - each pass plans per camera: max-days expiry, then byte quotas, then disk
+ *   pressure shared by weight (largest bytes/weight first), never inside min-days;
+ *   every batch is one range scan on the purge partial index
+ * - files are unlinked (or recycled) here; DB calls block this thread only
+ * - progress is reported through signals; nothing here touches the GUI thread
+ */
+class RetentionService : public QObject {
+    Q_OBJECT
+public:
+    RetentionService(const QString& archiveDir, DbWriter* db, SegmentFilePool* pool,
+                     StorageLedger* ledger);
+
+public slots:
+    // Per-camera policies keyed by main URL (cameras.json). Queue it on the
+    // retention thread whenever cameras or settings change.
+    void setPolicies(const QHash<QString, RetentionPolicy>& byUrl);
+    void start();          // call once on the retention thread (creates the timers)
+    void requestPurge();   // coalesced; safe from any thread via queued invoke
+    void reconcileLedger();
+
+signals:
+    void purgeStarted(qint64 needBytes);
+    void purgeProgress(qint64 freedBytes, int filesRemoved);
+    void purgeFinished(qint64 freedBytes, int filesRemoved);
+
+private:
+    void refreshWatermarks_();                            // compute bytes from % of total
+    bool shouldPurge_(qint64& needBytes, qint64& availBytes);
+    void runPurge_();
+    qint64 purgeBatch_(int cameraId, qint64 beforeUtcNs, int& removed);   // -1 on DB failure
+    // Batches from one camera (-1 = any) while more() holds; false once nothing is left.
+    bool drain_(int cameraId, qint64 beforeUtcNs, const std::function<bool()>& more,
+                qint64& freed, int& files);
+    RetentionPolicy policyFor_(int cameraId) const;   // defaults filled in
+    void resolvePolicies_();                          // policiesByUrl_ -> policyById_
+
+    QString          archiveDir_;
+    DbWriter*        db_   = nullptr;
+    SegmentFilePool* pool_ = nullptr;
+    StorageLedger*   ledger_ = nullptr;
+    RetentionCfg     rcfg_;
+    QHash<QString, RetentionPolicy> policiesByUrl_;
+    QHash<int, RetentionPolicy>     policyById_;     // resolved on reconcile / setPolicies
+    QHash<QString, int>             idsByUrl_;       // DbWriter's camera map at last reconcile
+    QTimer*          periodic_ = nullptr;
+    QTimer*          debounce_ = nullptr;
+    QTimer*          reconcile_ = nullptr;
+
+    static constexpr int kPeriodMs   = 5 * 60 * 1000;
+    static constexpr int kDebounceMs = 2000;
+    static constexpr int kReconcileMs = 60 * 1000;
+};
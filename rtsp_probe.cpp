@@ -0,0 +1,72 @@
+#include "rtsp_probe.h"
+#include <QTcpSocket>
+#include <QDebug>
+
+RtspProbe::RtspProbe(int index, const QString& url, int timeoutMs, QObject* parent)
+    : QObject(parent),
+      index_(index),
+      url_(url),
+      socket_(new QTcpSocket(this)),
+      timer_(this)
+{
+    timer_.setSingleShot(true);
+    timer_.setInterval(timeoutMs);
+    connect(&timer_, &QTimer::timeout, this, [this]{ finish(false, "timeout"); });
+    connect(socket_, &QTcpSocket::connected, this, &RtspProbe::onConnected);
+    connect(socket_, &QTcpSocket::readyRead, this, &RtspProbe::onReadyRead);
+    connect(socket_, &QAbstractSocket::errorOccurred, this, [this](QAbstractSocket::SocketError){
+        finish(false, socket_->errorString());
+    });
+}
+
+int RtspProbe::timeoutFromEnv() {
+    bool ok = false;
+    const int ms = qEnvironmentVariable("CAMVIGIL_RTSP_PROBE_TIMEOUT_MS").toInt(&ok);
+    return (ok && ms > 0) ? ms : 3000;
+}
+
+void RtspProbe::start() {
+    if (!url_.isValid() || url_.host().isEmpty()) {
+        // Defer so callers always see the result asynchronously.
+        QTimer::singleShot(0, this, [this]{ finish(false, "invalid url"); });
+        return;
+    }
+    timer_.start();
+    socket_->connectToHost(url_.host(), static_cast<quint16>(url_.port(554)));
+}
+
+void RtspProbe::cancel() {
+    done_ = true;
+    timer_.stop();
+    socket_->abort();
+    deleteLater();
+}
+
+void RtspProbe::onConnected() {
+    // Credentials stay out of the request line; OPTIONS never needs them.
+    const QByteArray target = url_.toString(QUrl::RemoveUserInfo).toUtf8();
+    socket_->write("OPTIONS " + target + " RTSP/1.0\r\n"
+                   "CSeq: 1\r\n"
+                   "User-Agent: CamVigil\r\n\r\n");
+}
+
+void RtspProbe::onReadyRead() {
+    reply_ += socket_->readAll();
+    const int eol = reply_.indexOf("\r\n");
+    if (eol < 0 && reply_.size() < 256) return;   // wait for the status line
+
+    const QByteArray status = reply_.left(eol < 0 ? reply_.size() : eol);
+    if (status.startsWith("RTSP/1.0"))
+        finish(true, QString::fromLatin1(status));
+    else
+        finish(false, "not an RTSP server");
+}
+
+void RtspProbe::finish(bool reachable, const QString& detail) {
+    if (done_) return;
+    done_ = true;
+    timer_.stop();
+    socket_->abort();
+    emit finished(index_, reachable, detail);
+    deleteLater();
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <QUrl>
+
+class QTcpSocket;
+
+/**
+ * rtsp_probe
+ * ----------
+ * Cheap reachability check for one RTSP URL.
+ * - TCP connect + a single OPTIONS request, no media setup, no decoder
+ * - any "RTSP/1.0" status line (even 401) counts as reachable
+ * - bounded by a timeout (CAMVIGIL_RTSP_PROBE_TIMEOUT_MS, default 3000)
+ * - fully asynchronous: run any number side by side on one event loop
+ * - emits finished() exactly once, then deletes itself
+ */
+class RtspProbe : public QObject {
+    Q_OBJECT
+public:
+    RtspProbe(int index, const QString& url, int timeoutMs, QObject* parent = nullptr);
+
+    void start();
+    void cancel();                      // no finished(); deletes itself
+
+    static int timeoutFromEnv();
+
+signals:
+    void finished(int index, bool reachable, const QString& detail);
+
+private:
+    void onConnected();
+    void onReadyRead();
+    void finish(bool reachable, const QString& detail);
+
+    int         index_;
+    QUrl        url_;
+    QTcpSocket* socket_ = nullptr;
+    QTimer      timer_;
+    QByteArray  reply_;
+    bool        done_ = false;
+};
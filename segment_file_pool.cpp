@@ -0,0 +1,93 @@
+#include "segment_file_pool.h"
+
+#include <QDir>
+#include <QFile>
+#include <QDebug>
+#include <QMutexLocker>
+#include <QStringList>
+#include <QtGlobal>
+#include <cstdio>
+#include <sys/stat.h>
+
+SegmentFilePool::SegmentFilePool(const QString& archiveDir)
+    : poolDir_(archiveDir + "/.pool")
+{
+    QDir().mkpath(poolDir_);
+
+    bool ok = false;
+    const int cap = qEnvironmentVariable("CAMVIGIL_SEGMENT_POOL_FILES").toInt(&ok);
+    if (ok && cap >= 0) capacity_ = cap;
+
+    // Adopt slots left behind by a previous run.
+    const QStringList leftovers = QDir(poolDir_).entryList(QStringList() << "slot_*.seg", QDir::Files);
+    for (const QString& name : leftovers) {
+        const QString path = poolDir_ + "/" + name;
+        if (free_.size() < capacity_) {
+            const qint64 sz = onDiskBytes_(path);
+            free_.push_back({ path, sz });
+            bytes_ += sz;
+        } else {
+            QFile::remove(path);
+        }
+    }
+    seq_ = quint64(free_.size());
+    qDebug() << "[SegmentPool] dir=" << poolDir_ << "capacity=" << capacity_
+             << "adopted=" << free_.size() << "bytes=" << bytes_;
+}
+
+bool SegmentFilePool::enabledFromEnv() {
+    const QString v = qEnvironmentVariable("CAMVIGIL_RECYCLE_SEGMENTS").trimmed().toLower();
+    return v == "1" || v == "true" || v == "on";
+}
+
+// st_blocks rather than st_size: what the slot holds on disk.
+qint64 SegmentFilePool::onDiskBytes_(const QString& path) {
+    struct stat st;
+    if (::stat(QFile::encodeName(path).constData(), &st) != 0) return 0;
+    return qint64(st.st_blocks) * 512;
+}
+
+QString SegmentFilePool::nextSlotPath_() {
+    QString path;
+    do {
+        path = QString("%1/slot_%2.seg").arg(poolDir_).arg(seq_++);
+    } while (QFile::exists(path));
+    return path;
+}
+
+bool SegmentFilePool::recycle(const QString& path) {
+    QMutexLocker lk(&mutex_);
+    if (free_.size() >= capacity_) return false;
+
+    const QString slot = nextSlotPath_();
+    if (std::rename(QFile::encodeName(path).constData(), QFile::encodeName(slot).constData()) != 0) {
+        qWarning() << "[SegmentPool] rename into pool failed:" << path;
+        return false;
+    }
+    const qint64 sz = onDiskBytes_(slot);
+    free_.push_back({ slot, sz });
+    bytes_ += sz;
+    return true;
+}
+
+bool SegmentFilePool::claim(const QString& targetPath) {
+    QMutexLocker lk(&mutex_);
+    while (!free_.isEmpty()) {
+        const QPair<QString, qint64> slot = free_.takeLast();
+        bytes_ -= slot.second;
+        if (std::rename(QFile::encodeName(slot.first).constData(), QFile::encodeName(targetPath).constData()) == 0)
+            return true;
+        qWarning() << "[SegmentPool] reuse failed:" << slot.first << "->" << targetPath;
+    }
+    return false;
+}
+
+int SegmentFilePool::size() const {
+    QMutexLocker lk(&mutex_);
+    return free_.size();
+}
+
+qint64 SegmentFilePool::pooledBytes() const {
+    QMutexLocker lk(&mutex_);
+    return bytes_;
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <QMutex>
+#include <QPair>
+#include <QString>
+#include <QVector>
+
+/**
+ * SegmentFilePool
+ * ---------------
+ * Free list of purged segment files kept for reuse by the recorders.
+ * - retention renames a victim into <archiveDir>/.pool instead of unlinking it
+ * - the next format-location renames a pooled file onto the new segment name,
+ *   so the ring buffer stops creating and unlinking an inode per segment
+ * - pooled files keep their extents: the recorder writes them through
+ *   SegmentSink, which overwrites in place and cuts the tail at EOS
+ * - pooledBytes() is reusable space the ledger counts as free
+ * - bounded (CAMVIGIL_SEGMENT_POOL_FILES, default 64); overflow is unlinked by the caller
+ * - thread-safe: recycle() runs on the retention side, claim() on streaming threads
+ */
+class SegmentFilePool {
+public:
+    explicit SegmentFilePool(const QString& archiveDir);
+
+    // CAMVIGIL_RECYCLE_SEGMENTS=1|true|on
+    static bool enabledFromEnv();
+
+    // Moves a finalized segment into the pool. False if the pool is full or the
+    // rename failed; the file is left where it was.
+    bool recycle(const QString& path);
+
+    // Renames a pooled file onto targetPath. False when the pool is empty.
+    bool claim(const QString& targetPath);
+
+    int    size() const;
+    qint64 pooledBytes() const;   // on-disk bytes held by free slots
+    QString poolDir() const { return poolDir_; }
+
+private:
+    QString nextSlotPath_();
+    static qint64 onDiskBytes_(const QString& path);
+
+    QString        poolDir_;
+    int            capacity_ = 64;
+    mutable QMutex mutex_;
+    QVector<QPair<QString, qint64>> free_;   // slot path, on-disk bytes
+    qint64         bytes_ = 0;
+    quint64        seq_ = 0;
+};
@@ -0,0 +1,215 @@
+#include "segment_sink.h"
+
+#include <gst/base/gstbasesink.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+namespace {
+
+struct CamvigilSegSink {
+    GstBaseSink parent;
+    gchar*  location;
+    int     fd;
+    guint64 offset;      // next write position
+    guint64 highWater;   // end of the data written since start
+};
+
+struct CamvigilSegSinkClass {
+    GstBaseSinkClass parent_class;
+};
+
+enum { PROP_0, PROP_LOCATION };
+
+GType camvigil_seg_sink_get_type();
+#define CAMVIGIL_SEG_SINK(obj) (reinterpret_cast<CamvigilSegSink*>(obj))
+
+G_DEFINE_TYPE(CamvigilSegSink, camvigil_seg_sink, GST_TYPE_BASE_SINK)
+
+GstStaticPadTemplate sinkTemplate = GST_STATIC_PAD_TEMPLATE(
+    "sink", GST_PAD_SINK, GST_PAD_ALWAYS, GST_STATIC_CAPS_ANY);
+
+void segSinkSetProperty(GObject* object, guint propId, const GValue* value, GParamSpec* pspec) {
+    CamvigilSegSink* self = CAMVIGIL_SEG_SINK(object);
+    switch (propId) {
+    case PROP_LOCATION:
+        if (self->fd >= 0) {
+            g_warning("camvigilsegsink: location cannot change while open");
+            break;
+        }
+        g_free(self->location);
+        self->location = g_value_dup_string(value);
+        break;
+    default:
+        G_OBJECT_WARN_INVALID_PROPERTY_ID(object, propId, pspec);
+        break;
+    }
+}
+
+void segSinkGetProperty(GObject* object, guint propId, GValue* value, GParamSpec* pspec) {
+    CamvigilSegSink* self = CAMVIGIL_SEG_SINK(object);
+    switch (propId) {
+    case PROP_LOCATION:
+        g_value_set_string(value, self->location);
+        break;
+    default:
+        G_OBJECT_WARN_INVALID_PROPERTY_ID(object, propId, pspec);
+        break;
+    }
+}
+
+void segSinkFinalize(GObject* object) {
+    CamvigilSegSink* self = CAMVIGIL_SEG_SINK(object);
+    g_free(self->location);
+    G_OBJECT_CLASS(camvigil_seg_sink_parent_class)->finalize(object);
+}
+
+// Drops whatever a previous occupant left past the new data.
+bool cutTail(CamvigilSegSink* self) {
+    if (self->fd < 0) return true;
+    if (::ftruncate(self->fd, off_t(self->highWater)) == 0) return true;
+    GST_ELEMENT_ERROR(self, RESOURCE, WRITE,
+                      ("Could not truncate \"%s\".", self->location), ("%s", strerror(errno)));
+    return false;
+}
+
+gboolean segSinkStart(GstBaseSink* sink) {
+    CamvigilSegSink* self = CAMVIGIL_SEG_SINK(sink);
+    if (!self->location) {
+        GST_ELEMENT_ERROR(self, RESOURCE, NOT_FOUND, ("No file name specified for writing."), (nullptr));
+        return FALSE;
+    }
+    // No O_TRUNC: a recycled file keeps its blocks until cutTail().
+    self->fd = ::open(self->location, O_WRONLY | O_CREAT | O_CLOEXEC, 0644);
+    if (self->fd < 0) {
+        GST_ELEMENT_ERROR(self, RESOURCE, OPEN_WRITE,
+                          ("Could not open file \"%s\" for writing.", self->location), ("%s", strerror(errno)));
+        return FALSE;
+    }
+    self->offset = 0;
+    self->highWater = 0;
+    return TRUE;
+}
+
+gboolean segSinkStop(GstBaseSink* sink) {
+    CamvigilSegSink* self = CAMVIGIL_SEG_SINK(sink);
+    if (self->fd < 0) return TRUE;
+    const bool ok = cutTail(self);
+    ::close(self->fd);
+    self->fd = -1;
+    return ok ? TRUE : FALSE;
+}
+
+GstFlowReturn segSinkRender(GstBaseSink* sink, GstBuffer* buffer) {
+    CamvigilSegSink* self = CAMVIGIL_SEG_SINK(sink);
+    GstMapInfo map;
+    if (!gst_buffer_map(buffer, &map, GST_MAP_READ)) return GST_FLOW_ERROR;
+
+    gsize done = 0;
+    while (done < map.size) {
+        const ssize_t n = ::pwrite(self->fd, map.data + done, map.size - done, off_t(self->offset + done));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            gst_buffer_unmap(buffer, &map);
+            GST_ELEMENT_ERROR(self, RESOURCE, WRITE,
+                              ("Error while writing to file \"%s\".", self->location), ("%s", strerror(errno)));
+            return GST_FLOW_ERROR;
+        }
+        done += gsize(n);
+    }
+    gst_buffer_unmap(buffer, &map);
+    self->offset += done;
+    self->highWater = MAX(self->highWater, self->offset);
+    return GST_FLOW_OK;
+}
+
+gboolean segSinkEvent(GstBaseSink* sink, GstEvent* event) {
+    CamvigilSegSink* self = CAMVIGIL_SEG_SINK(sink);
+    switch (GST_EVENT_TYPE(event)) {
+    case GST_EVENT_SEGMENT: {
+        const GstSegment* segment = nullptr;
+        gst_event_parse_segment(event, &segment);
+        if (segment->format == GST_FORMAT_BYTES) self->offset = segment->start;   // muxer seek
+        break;
+    }
+    case GST_EVENT_EOS:
+        // splitmuxsink reports fragment-closed right after this: the size must be final.
+        if (!cutTail(self)) {
+            gst_event_unref(event);
+            return FALSE;
+        }
+        break;
+    default:
+        break;
+    }
+    return GST_BASE_SINK_CLASS(camvigil_seg_sink_parent_class)->event(sink, event);
+}
+
+gboolean segSinkQuery(GstBaseSink* sink, GstQuery* query) {
+    CamvigilSegSink* self = CAMVIGIL_SEG_SINK(sink);
+    switch (GST_QUERY_TYPE(query)) {
+    case GST_QUERY_SEEKING: {
+        GstFormat fmt;
+        gst_query_parse_seeking(query, &fmt, nullptr, nullptr, nullptr);
+        gst_query_set_seeking(query, fmt, fmt == GST_FORMAT_BYTES || fmt == GST_FORMAT_DEFAULT, 0, -1);
+        return TRUE;
+    }
+    case GST_QUERY_POSITION: {
+        GstFormat fmt;
+        gst_query_parse_position(query, &fmt, nullptr);
+        if (fmt != GST_FORMAT_BYTES && fmt != GST_FORMAT_DEFAULT) break;
+        gst_query_set_position(query, GST_FORMAT_BYTES, gint64(self->offset));
+        return TRUE;
+    }
+    case GST_QUERY_FORMATS:
+        gst_query_set_formats(query, 2, GST_FORMAT_DEFAULT, GST_FORMAT_BYTES);
+        return TRUE;
+    default:
+        break;
+    }
+    return GST_BASE_SINK_CLASS(camvigil_seg_sink_parent_class)->query(sink, query);
+}
+
+static void camvigil_seg_sink_class_init(CamvigilSegSinkClass* klass) {
+    GObjectClass* gobjectClass = G_OBJECT_CLASS(klass);
+    GstElementClass* elementClass = GST_ELEMENT_CLASS(klass);
+    GstBaseSinkClass* baseClass = GST_BASE_SINK_CLASS(klass);
+
+    gobjectClass->set_property = segSinkSetProperty;
+    gobjectClass->get_property = segSinkGetProperty;
+    gobjectClass->finalize = segSinkFinalize;
+    g_object_class_install_property(gobjectClass, PROP_LOCATION,
+        g_param_spec_string("location", "File Location", "Segment file to overwrite in place",
+                            nullptr, GParamFlags(G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+
+    gst_element_class_set_static_metadata(elementClass, "CamVigil segment sink", "Sink/File",
+        "Writes a segment file in place, reusing a recycled file's extents", "CamVigil");
+    gst_element_class_add_static_pad_template(elementClass, &sinkTemplate);
+
+    baseClass->start  = GST_DEBUG_FUNCPTR(segSinkStart);
+    baseClass->stop   = GST_DEBUG_FUNCPTR(segSinkStop);
+    baseClass->render = GST_DEBUG_FUNCPTR(segSinkRender);
+    baseClass->event  = GST_DEBUG_FUNCPTR(segSinkEvent);
+    baseClass->query  = GST_DEBUG_FUNCPTR(segSinkQuery);
+}
+
+static void camvigil_seg_sink_init(CamvigilSegSink* self) {
+    self->location = nullptr;
+    self->fd = -1;
+    self->offset = 0;
+    self->highWater = 0;
+    gst_base_sink_set_sync(GST_BASE_SINK(self), FALSE);
+}
+
+} // namespace
+
+namespace SegmentSink {
+
+bool registerElement() {
+    static const gboolean ok = gst_element_register(nullptr, kFactoryName, GST_RANK_NONE,
+                                                    camvigil_seg_sink_get_type());
+    return ok;
+}
+
+} // namespace SegmentSink
@@ -0,0 +1,23 @@
+#pragma once
+#include <gst/gst.h>
+
+/**
+ * SegmentSink ("camvigilsegsink")
+ * -------------------------------
+ * filesink stand-in for recycled segment files (CAMVIGIL_RECYCLE_SEGMENTS).
+ * - opens `location` without O_TRUNC, so a file claimed from SegmentFilePool
+ *   keeps its extents and is overwritten in place
+ * - byte SEGMENT events from the muxer (header/cues rewrites) move the write
+ *   offset; answers the seeking query like filesink so matroskamux seeks back
+ * - at EOS (and on stop) the file is cut to the highest offset written, so a
+ *   longer previous occupant leaves no tail behind
+ * splitmuxsink creates one per fragment through its sink-factory property.
+ */
+namespace SegmentSink {
+
+constexpr const char* kFactoryName = "camvigilsegsink";
+
+// Registers the element with the running GStreamer (idempotent; after gst_init()).
+bool registerElement();
+
+} // namespace SegmentSink
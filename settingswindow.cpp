@@ -147,6 +147,8 @@ SettingsWindow::SettingsWindow(ArchiveManager* archiveManager,
             archiveManager, &ArchiveManager::cleanupArchive);
     connect(archiveManager, &ArchiveManager::segmentWritten,
             storageWidget, &StorageDetailsWidget::updateStorageInfo);
+    connect(archiveManager, &ArchiveManager::purgeFinished,
+            storageWidget, &StorageDetailsWidget::updateStorageInfo);
 
     scrollLayout->addStretch();
 
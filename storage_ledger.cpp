@@ -0,0 +1,105 @@
+#include "storage_ledger.h"
+
+#include <QReadLocker>
+#include <QWriteLocker>
+
+void StorageLedger::reconcile(qint64 fsTotalBytes, qint64 fsAvailBytes,
+                              const QVector<Usage>& rows, const QHash<int, QString>& cameraNames,
+                              const QHash<SegmentKey, qint64>& openOnDisk)
+{
+    QWriteLocker lk(&lock_);
+    perCamera_.clear();
+    perDay_.clear();
+    perCameraDay_.clear();
+    used_ = 0;
+    for (const Usage& u : rows) apply_(u.cameraId, u.day, u.bytes);
+    consumed_ = 0;
+    openAtReconcile_ = openOnDisk;
+    fsTotal_ = fsTotalBytes;
+    fsAvail_ = fsAvailBytes;
+    names_   = cameraNames;
+    valid_   = true;
+}
+
+void StorageLedger::addSegment(int cameraId, qint64 startUtcNs, qint64 bytes)
+{
+    if (bytes <= 0) return;
+    QWriteLocker lk(&lock_);
+    apply_(cameraId, dayOf(startUtcNs), bytes);
+    // Whatever the open file already held is inside fsAvail_.
+    const qint64 counted = openAtReconcile_.take(qMakePair(cameraId, startUtcNs));
+    consumed_ += qMax<qint64>(0, bytes - counted);
+}
+
+void StorageLedger::removeSegment(int cameraId, qint64 startUtcNs, qint64 bytes)
+{
+    if (bytes <= 0) return;
+    QWriteLocker lk(&lock_);
+    apply_(cameraId, dayOf(startUtcNs), -bytes);
+    consumed_ -= bytes;
+}
+
+void StorageLedger::apply_(int cameraId, const QDate& day, qint64 delta)
+{
+    used_ += delta;
+    auto bump = [delta](qint64& v){ v = qMax<qint64>(0, v + delta); };
+    bump(perCamera_[cameraId]);
+    bump(perDay_[day]);
+    bump(perCameraDay_[qMakePair(cameraId, day)]);
+    if (perCameraDay_.value(qMakePair(cameraId, day)) == 0) perCameraDay_.remove(qMakePair(cameraId, day));
+    if (perDay_.value(day) == 0) perDay_.remove(day);
+}
+
+bool StorageLedger::isValid() const
+{
+    QReadLocker lk(&lock_);
+    return valid_;
+}
+
+qint64 StorageLedger::totalBytes() const
+{
+    QReadLocker lk(&lock_);
+    return fsTotal_;
+}
+
+qint64 StorageLedger::usedBytes() const
+{
+    QReadLocker lk(&lock_);
+    return used_;
+}
+
+qint64 StorageLedger::freeBytes() const
+{
+    QReadLocker lk(&lock_);
+    return qBound<qint64>(0, fsAvail_ - consumed_, fsTotal_);
+}
+
+qint64 StorageLedger::cameraBytes(int cameraId) const
+{
+    QReadLocker lk(&lock_);
+    return perCamera_.value(cameraId);
+}
+
+qint64 StorageLedger::dayBytes(const QDate& day) const
+{
+    QReadLocker lk(&lock_);
+    return perDay_.value(day);
+}
+
+qint64 StorageLedger::cameraDayBytes(int cameraId, const QDate& day) const
+{
+    QReadLocker lk(&lock_);
+    return perCameraDay_.value(qMakePair(cameraId, day));
+}
+
+QHash<int, qint64> StorageLedger::perCamera() const
+{
+    QReadLocker lk(&lock_);
+    return perCamera_;
+}
+
+QHash<int, QString> StorageLedger::cameraNames() const
+{
+    QReadLocker lk(&lock_);
+    return names_;
+}
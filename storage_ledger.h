@@ -0,0 +1,73 @@
+#pragma once
+#include <QDate>
+#include <QDateTime>
+#include <QHash>
+#include <QPair>
+#include <QReadWriteLock>
+#include <QString>
+#include <QVector>
+
+/**
+ * StorageLedger
+ * -------------
+ * In-memory byte accounting for the archive (owned by ArchiveManager).
+ * - fed by DbWriter (finalized size_bytes, purged rows) as it happens
+ * - reconciled periodically by RetentionService from one statfs plus one
+ *   GROUP BY over finalized segments, both taken on the DB thread so no
+ *   finalize/purge can land in between
+ * - free space is the statfs figure (plus recycled pool slots, reused in place)
+ *   minus growth since: bytes an open segment already had on disk at the
+ *   snapshot are not charged again when it finalizes
+ * - answers used / free / per-camera / per-day in O(1) under a read lock,
+ *   so retention and the storage panel never call statfs themselves
+ * Days are local calendar dates of the segment start, the same key as
+ * camera_days and the playback date picker.
+ */
+class StorageLedger {
+public:
+    struct Usage {
+        int     cameraId = 0;
+        QDate   day;
+        qint64  bytes    = 0;
+    };
+
+    static QDate dayOf(qint64 startUtcNs) {
+        return QDateTime::fromMSecsSinceEpoch(startUtcNs / 1000000).date();
+    }
+
+    using SegmentKey = QPair<int, qint64>;   // (camera id, start_utc_ns)
+
+    // Full rebuild: filesystem totals + finalized bytes per (camera, day), plus
+    // the on-disk bytes of segments still open at the statfs snapshot.
+    void reconcile(qint64 fsTotalBytes, qint64 fsAvailBytes,
+                   const QVector<Usage>& rows, const QHash<int, QString>& cameraNames,
+                   const QHash<SegmentKey, qint64>& openOnDisk);
+
+    void addSegment(int cameraId, qint64 startUtcNs, qint64 bytes);
+    void removeSegment(int cameraId, qint64 startUtcNs, qint64 bytes);
+
+    bool   isValid() const;                 // false until the first reconcile
+    qint64 totalBytes() const;              // filesystem capacity
+    qint64 usedBytes() const;               // finalized archive bytes
+    qint64 freeBytes() const;               // last statfs, adjusted by changes since
+    qint64 cameraBytes(int cameraId) const;
+    qint64 dayBytes(const QDate& day) const;
+    qint64 cameraDayBytes(int cameraId, const QDate& day) const;
+    QHash<int, qint64>  perCamera() const;
+    QHash<int, QString> cameraNames() const;
+
+private:
+    void apply_(int cameraId, const QDate& day, qint64 delta);   // caller holds the write lock
+
+    mutable QReadWriteLock lock_;
+    bool   valid_ = false;
+    qint64 fsTotal_ = 0;
+    qint64 fsAvail_ = 0;            // at last reconcile
+    qint64 consumed_ = 0;           // disk growth (net of purges) since then
+    qint64 used_ = 0;
+    QHash<SegmentKey, qint64>         openAtReconcile_;
+    QHash<int, qint64>                perCamera_;
+    QHash<QDate, qint64>              perDay_;
+    QHash<QPair<int, QDate>, qint64>  perCameraDay_;
+    QHash<int, QString>               names_;
+};
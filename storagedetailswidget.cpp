@@ -7,6 +7,8 @@
 #include <QTimer>
 #include <QDateTime>
 #include <QFileInfo>
+#include <QStringList>
+#include <algorithm>
 
 StorageDetailsWidget::StorageDetailsWidget(ArchiveManager* archiveManager, QWidget *parent)
     : QWidget(parent), archiveManager(archiveManager)
@@ -28,6 +30,11 @@ StorageDetailsWidget::StorageDetailsWidget(ArchiveManager* archiveManager, QWidg
     capacityDetailsLabel->setStyleSheet("font-size: 18px; font-weight: bold; color: white;");
     formLayout->addRow(new QLabel(""), capacityDetailsLabel);
 
+    perCameraLabel = new QLabel(this);
+    perCameraLabel->setStyleSheet("font-size: 16px; color: white;");
+    perCameraLabel->setWordWrap(true);
+    formLayout->addRow(new QLabel("Per Camera"), perCameraLabel);
+
     durationCombo = new QComboBox(this);
     durationCombo->addItem("1 min", 60);
     durationCombo->addItem("5 mins", 300);
@@ -68,9 +75,17 @@ void StorageDetailsWidget::updateStorageInfo() {
     }
 
     storageDeviceStatusLabel->setText(root);
-    QStorageInfo storage(root);
-    const qint64 total = storage.bytesTotal();
-    const qint64 avail = storage.bytesAvailable();
+    // Ledger answers from memory; statfs only until retention's first reconcile.
+    const StorageLedger& ledger = archiveManager->storageLedger();
+    qint64 total = 0, avail = 0;
+    if (ledger.isValid()) {
+        total = ledger.totalBytes();
+        avail = ledger.freeBytes();
+    } else {
+        QStorageInfo storage(root);
+        total = storage.bytesTotal();
+        avail = storage.bytesAvailable();
+    }
     const qint64 used  = (total > 0) ? (total - avail) : 0;
 
     const qint64 totalGB = total / (1024LL * 1024LL * 1024LL);
@@ -80,6 +95,18 @@ void StorageDetailsWidget::updateStorageInfo() {
     capacityDetailsLabel->setText(QString("%1 GB Used | %2 GB Available | %3 GB Total")
                                   .arg(usedGB).arg(availGB).arg(totalGB));
 
+    QStringList perCam;
+    const QHash<int, qint64> byCam = ledger.perCamera();
+    const QHash<int, QString> names = ledger.cameraNames();
+    QList<int> ids = byCam.keys();
+    std::sort(ids.begin(), ids.end());
+    for (int id : ids) {
+        const QString name = names.value(id).isEmpty() ? QString("Cam %1").arg(id) : names.value(id);
+        perCam << QString("%1: %2 GB").arg(name)
+                      .arg(double(byCam.value(id)) / (1024.0 * 1024.0 * 1024.0), 0, 'f', 1);
+    }
+    perCameraLabel->setText(perCam.join(" | "));
+
     int usedPercent = (total > 0) ? int((used * 100) / total) : 0;
     storageProgressBar->setValue(usedPercent);
     storageProgressBar->setFormat(QString("%1% Used").arg(usedPercent));
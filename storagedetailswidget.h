@@ -28,6 +28,7 @@ private:
     QLabel* storageDeviceStatusLabel{};
     QProgressBar* storageProgressBar{};
     QLabel* capacityDetailsLabel{};
+    QLabel* perCameraLabel{};
     QComboBox* durationCombo{};
     ArchiveManager* archiveManager{};
     QTimer* refreshTimer{};
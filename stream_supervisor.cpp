@@ -0,0 +1,108 @@
+#include "stream_supervisor.h"
+#include <QTimer>
+#include <QDateTime>
+#include <QRandomGenerator>
+#include <QDebug>
+
+static int envMs(const char* name, int fallback) {
+    bool ok = false;
+    const int v = qEnvironmentVariable(name).toInt(&ok);
+    return (ok && v > 0) ? v : fallback;
+}
+
+StreamSupervisor::StreamSupervisor(const QString& name, QObject* parent)
+    : QObject(parent),
+      name_(name),
+      baseMs_(envMs("CAMVIGIL_BACKOFF_BASE_MS", 1000)),
+      maxMs_(envMs("CAMVIGIL_BACKOFF_MAX_MS", 60000))
+{
+    qRegisterMetaType<StreamHealth>("StreamHealth");
+}
+
+QString StreamSupervisor::stateName(StreamHealth s) {
+    switch (s) {
+    case StreamHealth::Connecting: return "connecting";
+    case StreamHealth::Live:       return "live";
+    case StreamHealth::Stalled:    return "stalled";
+    case StreamHealth::BackingOff: return "backing-off";
+    }
+    return "unknown";
+}
+
+StreamSupervisor::Entry& StreamSupervisor::entry_(int index) {
+    auto it = entries_.find(index);
+    if (it == entries_.end()) {
+        it = entries_.insert(index, Entry{});
+        Entry& e = it.value();
+        e.retry = new QTimer(this);
+        e.retry->setSingleShot(true);
+        connect(e.retry, &QTimer::timeout, this, [this, index]{
+            markConnecting(index);
+            emit restartRequested(index);
+        });
+    }
+    return it.value();
+}
+
+void StreamSupervisor::setState_(int index, Entry& e, StreamHealth s) {
+    if (e.state == s) return;
+    e.state = s;
+    qDebug() << "[Supervisor]" << name_ << "cam" << index << "->" << stateName(s);
+    emit stateChanged(index, s);
+}
+
+void StreamSupervisor::markConnecting(int index) {
+    Entry& e = entry_(index);
+    e.retry->stop();
+    setState_(index, e, StreamHealth::Connecting);
+}
+
+void StreamSupervisor::markLive(int index) {
+    Entry& e = entry_(index);
+    if (e.state == StreamHealth::Live) return;
+    e.liveSinceMs = QDateTime::currentMSecsSinceEpoch();
+    setState_(index, e, StreamHealth::Live);
+}
+
+void StreamSupervisor::markFailed(int index, const QString& reason) {
+    Entry& e = entry_(index);
+    if (e.state == StreamHealth::BackingOff) return;   // already scheduled
+
+    if (e.state == StreamHealth::Live &&
+        QDateTime::currentMSecsSinceEpoch() - e.liveSinceMs >= kStableMs) {
+        e.attempts = 0;
+    }
+    setState_(index, e, StreamHealth::Stalled);
+
+    const int delay = nextDelayMs_(e.attempts);
+    ++e.attempts;
+    qWarning() << "[Supervisor]" << name_ << "cam" << index << "failed (" << reason
+               << "), retry" << e.attempts << "in" << delay << "ms";
+    e.retry->start(delay);
+    setState_(index, e, StreamHealth::BackingOff);
+}
+
+void StreamSupervisor::forget(int index) {
+    auto it = entries_.find(index);
+    if (it == entries_.end()) return;
+    delete it.value().retry;
+    entries_.erase(it);
+}
+
+void StreamSupervisor::clear() {
+    for (auto& e : entries_) delete e.retry;
+    entries_.clear();
+}
+
+StreamHealth StreamSupervisor::state(int index) const {
+    return entries_.value(index).state;
+}
+
+int StreamSupervisor::attempts(int index) const {
+    return entries_.value(index).attempts;
+}
+
+int StreamSupervisor::nextDelayMs_(int attempt) const {
+    const qint64 d = qMin<qint64>(maxMs_, qint64(baseMs_) << qMin(attempt, 16));
+    return int(d / 2) + QRandomGenerator::global()->bounded(int(d / 2) + 1);
+}
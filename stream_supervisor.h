@@ -0,0 +1,61 @@
+#pragma once
+#include <QObject>
+#include <QHash>
+#include <QMetaType>
+#include <QString>
+
+class QTimer;
+
+// Per-camera pipeline health, shared by live view and recording.
+enum class StreamHealth { Connecting, Live, Stalled, BackingOff };
+Q_DECLARE_METATYPE(StreamHealth)
+
+/**
+ * stream_supervisor
+ * -----------------
+ * Health state machine + reconnect scheduler for a set of camera pipelines.
+ * - owner reports markConnecting/markLive/markFailed; the supervisor never
+ *   touches pipelines itself
+ * - a failure moves the camera Stalled -> BackingOff and emits
+ *   restartRequested(index) after a jittered exponential delay
+ *   (full jitter over [d/2, d], d = base * 2^attempt, capped)
+ * - attempts reset only after the camera stayed Live for kStableMs, so a
+ *   flapping camera keeps backing off instead of hammering the device
+ * Tunables: CAMVIGIL_BACKOFF_BASE_MS (1000), CAMVIGIL_BACKOFF_MAX_MS (60000).
+ */
+class StreamSupervisor : public QObject {
+    Q_OBJECT
+public:
+    explicit StreamSupervisor(const QString& name, QObject* parent = nullptr);
+
+    void markConnecting(int index);
+    void markLive(int index);
+    void markFailed(int index, const QString& reason);
+    void forget(int index);
+    void clear();
+
+    StreamHealth state(int index) const;
+    int attempts(int index) const;
+    static QString stateName(StreamHealth s);
+
+signals:
+    void stateChanged(int index, StreamHealth state);
+    void restartRequested(int index);
+
+private:
+    struct Entry {
+        StreamHealth state = StreamHealth::Connecting;
+        int     attempts = 0;
+        qint64  liveSinceMs = 0;
+        QTimer* retry = nullptr;
+    };
+    Entry& entry_(int index);
+    void setState_(int index, Entry& e, StreamHealth s);
+    int  nextDelayMs_(int attempt) const;
+
+    QString name_;
+    QHash<int, Entry> entries_;
+    int baseMs_ = 1000;
+    int maxMs_  = 60000;
+    static constexpr qint64 kStableMs = 30000;
+};
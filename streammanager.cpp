@@ -1,88 +1,245 @@
 #include "streammanager.h"
 #include <QDebug>
-#include <opencv2/opencv.hpp>
 
 StreamManager::StreamManager(QObject* parent)
-    : QObject(parent)
+    : QObject(parent),
+      handoffMode(handoffFromEnv()),
+      stallTimer(this)
 {
+    qRegisterMetaType<LiveFrame>("LiveFrame");
+    qRegisterMetaType<std::string>("std::string");
+
+    bool ok = false;
+    const int poolThreads = qEnvironmentVariable("CAMVIGIL_LIVE_POOL_THREADS").toInt(&ok);
+    livePool.setMaxThreadCount(ok && poolThreads > 0 ? poolThreads : 2);
+
+    stallTimer.setInterval(1000);
+    connect(&stallTimer, &QTimer::timeout, this, &StreamManager::checkStalls);
+
+    supervisor = new StreamSupervisor("live", this);
+    connect(supervisor, &StreamSupervisor::stateChanged, this, &StreamManager::healthChanged);
+    connect(supervisor, &StreamSupervisor::restartRequested, this, &StreamManager::probeCamera);
+}
+
+FrameHandoff StreamManager::handoffFromEnv() {
+    const QString mode = qEnvironmentVariable("CAMVIGIL_LIVE_HANDOFF").trimmed().toLower();
+    return mode == "pixmap" ? FrameHandoff::Pixmap : FrameHandoff::Sample;
+}
+
+void StreamManager::connectWorker(StreamWorker* worker) {
+    // Signals are emitted from streaming/pool threads; queue them onto ours.
+    connect(worker, &StreamWorker::frameReady, this, [this](int idx, const QPixmap &pixmap){
+        emit frameReady(idx, pixmap);
+    }, Qt::QueuedConnection);
+    connect(worker, &StreamWorker::sampleReady, this, &StreamManager::sampleReady, Qt::QueuedConnection);
+    connect(worker, &StreamWorker::streamError, this, [this, worker](int idx, const std::string& url){
+        qWarning() << "StreamWorker[" << idx << "] error on" << QString::fromStdString(url);
+        WorkerInfo* info = findWorker(idx);
+        if (info && info->worker == worker) failWorker(*info, "pipeline error");
+    }, Qt::QueuedConnection);
+}
+
+WorkerInfo* StreamManager::findWorker(int index) {
+    for (auto &info : workers) {
+        if (info.index == index) return &info;
+    }
+    return nullptr;
+}
+
+// Retire the worker and hand the camera to the supervisor's backoff.
+void StreamManager::failWorker(WorkerInfo& info, const QString& reason) {
+    if (info.worker) {
+        retireWorker(info.worker);
+        info.worker = nullptr;
+    }
+    supervisor->markFailed(info.index, reason);
+}
+
+void StreamManager::launchWorker(StreamWorker* worker, int index) {
+    worker->setTargetFps(fpsOverrides.value(index, StreamWorker::targetFpsFromEnv()));
+    worker->setVisible(!hiddenTiles.contains(index));
+    startProcess(worker);
+}
+
+// process() and a later stop() may run on different pool threads in either order;
+// both tasks hold a reference, so the worker is deleted only after the last one returns.
+void StreamManager::startProcess(StreamWorker* worker) {
+    std::shared_ptr<StreamWorker> ref(worker);
+    launched.insert(worker, ref);
+    livePool.start([ref]{ ref->process(); });
+}
+
+// The worker never receives events, so it can be torn down and deleted on a pool thread.
+void StreamManager::retireWorker(StreamWorker* worker) {
+    std::shared_ptr<StreamWorker> ref = launched.take(worker);
+    if (!ref) ref.reset(worker);
+    livePool.start([ref]{ ref->stop(); });
+}
+
+void StreamManager::setTargetFps(int index, double fps) {
+    fpsOverrides.insert(index, fps);
+    for (auto &info : workers) {
+        if (info.index == index && info.worker) {
+            info.worker->setTargetFps(fps);
+        }
+    }
+}
+
+// Replaces the old per-thread null-sample counting. Fresh samples mark the camera
+// live; a silent worker is retired and the supervisor schedules the reconnect.
+void StreamManager::checkStalls() {
+    for (auto &info : workers) {
+        StreamWorker* w = info.worker;
+        if (!w) continue;
+        if (w->hasFailed()) {
+            failWorker(info, "pipeline error");
+            continue;
+        }
+        if (!w->isCameraConnected()) continue;
+        // Live only once a frame has actually arrived; until then the connect timeout applies.
+        const bool gotFrame = w->hasFirstSample();
+        const qint64 limit = gotFrame ? kStallTimeoutMs : kConnectTimeoutMs;
+        const qint64 silent = w->msSinceLastSample();
+        if (gotFrame && silent < kStallTimeoutMs) {
+            if (supervisor->state(info.index) != StreamHealth::Live) supervisor->markLive(info.index);
+        } else if (silent >= limit) {
+            qWarning() << "StreamWorker[" << info.index << "] timeout: No frames received for"
+                       << silent << "ms.";
+            failWorker(info, "no frames");
+        }
+    }
+    // Same grace as the substream: long GOPs or the UDP->TCP fallback delay the first frame.
+    StreamWorker* mw = mainWorker.worker;
+    if (mw && (mw->hasFailed() ||
+        (mw->isCameraConnected()
+         && mw->msSinceLastSample() >= (mw->hasFirstSample() ? kStallTimeoutMs : kConnectTimeoutMs)))) {
+        qWarning() << "Main stream for camera" << mainWorker.index << "stalled; falling back to substream.";
+        const int idx = mainWorker.index;
+        stopMainStream();
+        emit mainStreamLost(idx);
+    }
+}
+
+void StreamManager::setLiveVisible(int index, bool visible) {
+    if (visible) hiddenTiles.remove(index);
+    else hiddenTiles.insert(index);
+    if (WorkerInfo* info = findWorker(index)) {
+        if (info->worker) info->worker->setVisible(visible);
+    }
+}
+
+void StreamManager::startMainStream(int index) {
+    if (index < 0 || index >= static_cast<int>(mainUrls.size()) || mainUrls[index].empty()) return;
+    if (mainWorker.worker && mainWorker.index == index) return;
+    stopMainStream();
+
+    // Sample handoff regardless of the wall mode: the viewer uploads main-stream frames to GL.
+    auto* worker = new StreamWorker(mainUrls[index], index, FrameHandoff::Sample);
+    connect(worker, &StreamWorker::sampleReady, this, &StreamManager::mainFrameReady, Qt::QueuedConnection);
+    connect(worker, &StreamWorker::streamError, this, [this](int idx, const std::string&){
+        if (mainWorker.index == idx) {
+            stopMainStream();
+            emit mainStreamLost(idx);
+        }
+    }, Qt::QueuedConnection);
+    worker->setTargetFps(0);
+    startProcess(worker);
+    mainWorker = {mainUrls[index], index, worker};
+    qDebug() << "Main stream started for camera" << index;
+}
+
+void StreamManager::stopMainStream() {
+    if (!mainWorker.worker) return;
+    qDebug() << "Main stream stopped for camera" << mainWorker.index;
+    retireWorker(mainWorker.worker);
+    mainWorker = {std::string(), -1, nullptr};
 }
 
 StreamManager::~StreamManager() {
     stopStreaming();
+    livePool.waitForDone();
 }
 
-void StreamManager::startStreaming(const std::vector<CamHWProfile>& cameraProfiles, const std::vector<QLabel*>& labels) {
+void StreamManager::startStreaming(const std::vector<CamHWProfile>& cameraProfiles) {
     stopStreaming();
-    this->labels = labels;
-
-    for (size_t i = 0; i < cameraProfiles.size(); ++i) {
-        int currentIndex = static_cast<int>(i);
-        const std::string& subUrl = cameraProfiles[i].suburl;
-
-        // Checks camera connection using OpenCV with the suburl.
-        cv::VideoCapture cap(subUrl);
-        if (!cap.isOpened()) {
-            qDebug() << "Initial connection check failed for camera substream at index:" << currentIndex;
-            if (currentIndex < static_cast<int>(labels.size()) && labels[currentIndex]) {
-                labels[currentIndex]->setText("❌ Camera Unavailable");
-                labels[currentIndex]->setAlignment(Qt::AlignCenter);
-                labels[currentIndex]->setStyleSheet("color: red; font-size: 18px; font-weight: bold;");
-            }
-            continue;
-        }
-        cap.release();
 
-        // Create a StreamWorker for a valid camera using the suburl.
-        StreamWorker* worker = new StreamWorker(subUrl, currentIndex);
-        QThread* thread = new QThread();
-        worker->moveToThread(thread);
+    subUrls.clear();
+    mainUrls.clear();
+    for (const auto& profile : cameraProfiles) {
+        subUrls.push_back(profile.suburl);
+        mainUrls.push_back(profile.url);
+    }
+    for (size_t i = 0; i < subUrls.size(); ++i) {
+        probeCamera(static_cast<int>(i));
+    }
+    stallTimer.start();
+}
 
-        connect(thread, &QThread::started, worker, &StreamWorker::process);
-        connect(worker, &StreamWorker::frameReady, this, [this](int idx, const QPixmap &pixmap){
-            emit frameReady(idx, pixmap);
-        });
-        connect(worker, &StreamWorker::finished, thread, &QThread::quit);
-        connect(worker, &StreamWorker::finished, worker, &QObject::deleteLater);
-        connect(thread, &QThread::finished, thread, &QObject::deleteLater);
+// Checks camera connection with a lightweight RTSP OPTIONS on the suburl.
+// Used for the initial start and for every supervisor-scheduled reconnect.
+void StreamManager::probeCamera(int index) {
+    if (index < 0 || index >= static_cast<int>(subUrls.size())) return;
+    supervisor->markConnecting(index);
 
+    auto* probe = new RtspProbe(index, QString::fromStdString(subUrls[index]),
+                                RtspProbe::timeoutFromEnv(), this);
+    connect(probe, &RtspProbe::finished, this,
+            [this, probe](int idx, bool reachable, const QString& detail){
+        probes.removeAll(QPointer<RtspProbe>(probe));
+        onProbeFinished(idx, reachable, detail);
+    });
+    probes.append(probe);
+    probe->start();
+}
 
-        thread->start();
-        workers.push_back({subUrl, thread, worker});
+void StreamManager::onProbeFinished(int index, bool reachable, const QString& detail) {
+    const std::string& url = subUrls[index];
+    if (!reachable) {
+        qWarning() << "Connection check failed for camera substream at index:" << index << detail;
+        if (supervisor->attempts(index) == 0) emit cameraUnavailable(index);
+        supervisor->markFailed(index, detail);
+        return;
     }
+
+    // Create a StreamWorker for a valid camera using the suburl.
+    StreamWorker* worker = new StreamWorker(url, index, handoffMode);
+    connectWorker(worker);
+    launchWorker(worker, index);
+
+    WorkerInfo* info = findWorker(index);
+    if (!info) {
+        workers.push_back({url, index, nullptr});
+        info = &workers.back();
+    }
+    if (info->worker) retireWorker(info->worker);
+    info->worker = worker;
 }
 
 void StreamManager::stopStreaming() {
+    stallTimer.stop();
+    supervisor->clear();
+    stopMainStream();
+    for (const auto& probe : qAsConst(probes)) {
+        if (probe) probe->cancel();
+    }
+    probes.clear();
     for (auto &info : workers) {
         if (info.worker) {
-            info.worker->stop();
+            retireWorker(info.worker);
         }
     }
     workers.clear();
 }
 
 void StreamManager::restartStream(const std::string& url) {
-    for (size_t i = 0; i < workers.size(); ++i) {
-        if (workers[i].url == url) {
+    for (auto &info : workers) {
+        if (info.url == url) {
             qDebug() << "Restarting stream for" << QString::fromStdString(url);
-            if (workers[i].worker) {
-                workers[i].worker->stop();
+            if (info.worker) {
+                retireWorker(info.worker);
+                info.worker = nullptr;
             }
-
-            StreamWorker* newWorker = new StreamWorker(url, static_cast<int>(i));
-            QThread* newThread = new QThread();
-            newWorker->moveToThread(newThread);
-
-            connect(newThread, &QThread::started, newWorker, &StreamWorker::process);
-            connect(newWorker, &StreamWorker::frameReady, this, [this](int idx, const QPixmap &pixmap){
-                emit frameReady(idx, pixmap);
-            });
-            connect(newWorker, &StreamWorker::finished, newThread, &QThread::quit);
-            connect(newWorker, &StreamWorker::finished, newWorker, &QObject::deleteLater);
-            connect(newThread, &QThread::finished, newThread, &QObject::deleteLater);
-
-            newThread->start();
-            workers[i].worker = newWorker;
-            workers[i].thread = newThread;
+            probeCamera(info.index);
             break;
         }
     }
@@ -2,17 +2,23 @@
 #define STREAMMANAGER_H
 
 #include <QObject>
-#include <QLabel>
-#include <QThread>
+#include <QHash>
+#include <QSet>
+#include <QPointer>
+#include <QThreadPool>
+#include <QTimer>
 #include <vector>
 #include <string>
+#include <memory>
 #include "streamworker.h"
 #include "camerastreams.h"
+#include "rtsp_probe.h"
+#include "stream_supervisor.h"
 
-// Structure that ties each worker to its thread & URL.
+// Structure that ties each worker to its tile index & URL.
 struct WorkerInfo {
     std::string url;
-    QThread* thread;
+    int index;
     StreamWorker* worker;
 };
 
@@ -23,18 +29,69 @@ public:
     ~StreamManager();
 
     //  now accepts a vector of CamHWProfile to use the suburl for streaming.
-    void startStreaming(const std::vector<CamHWProfile>& cameraProfiles, const std::vector<QLabel*>& labels);
+    //  All cameras are probed in parallel; each worker starts as soon as its camera answers.
+    void startStreaming(const std::vector<CamHWProfile>& cameraProfiles);
     void stopStreaming();
     void restartStream(const std::string& url);
 
+    // Live pipeline health per camera (connecting/live/stalled/backing-off).
+    StreamHealth health(int index) const { return supervisor->state(index); }
+
+    // CAMVIGIL_LIVE_HANDOFF=pixmap restores the QLabel wall; default hands samples to the GL grid.
+    static FrameHandoff handoffFromEnv();
+    FrameHandoff handoff() const { return handoffMode; }
+
+    // Per-camera live rate cap (0 = camera rate). Defaults to CAMVIGIL_LIVE_FPS.
+    void setTargetFps(int index, double fps);
+
+public slots:
+    // Fullscreen: decode camera `index`'s main stream (uncapped) until stopMainStream().
+    // At most one main-stream session exists at a time.
+    void startMainStream(int index);
+    void stopMainStream();
+    // Tile visibility from the UI: hidden tiles decode keyframes only.
+    void setLiveVisible(int index, bool visible);
+
 signals:
     // Forward frameReady signals from individual workers.
     void frameReady(int index, const QPixmap &pixmap);
+    void sampleReady(int index, const LiveFrame &frame);
+    // Initial connectivity check failed; the UI decides how to show it.
+    void cameraUnavailable(int index);
+    // Main-stream frames for the fullscreen viewer; mainStreamLost when that session dies.
+    void mainFrameReady(int index, const LiveFrame &frame);
+    void mainStreamLost(int index);
+    void healthChanged(int index, StreamHealth state);
    // void workerFinished();
 
 private:
+    void connectWorker(StreamWorker* worker);
+    void launchWorker(StreamWorker* worker, int index);
+    void startProcess(StreamWorker* worker);
+    void retireWorker(StreamWorker* worker);
+    void checkStalls();
+    void probeCamera(int index);
+    void onProbeFinished(int index, bool reachable, const QString& detail);
+    void failWorker(WorkerInfo& info, const QString& reason);
+    WorkerInfo* findWorker(int index);
+
     std::vector<WorkerInfo> workers;
-    std::vector<QLabel*> labels;
+    FrameHandoff handoffMode;
+    std::vector<std::string> subUrls;      // index -> live (sub) stream URL
+    std::vector<std::string> mainUrls;     // index -> main stream URL
+    StreamSupervisor* supervisor = nullptr;
+    WorkerInfo mainWorker{std::string(), -1, nullptr};
+
+    // Pipelines stream on GStreamer's own threads; this small fixed pool only
+    // runs the blocking start/stop state changes (CAMVIGIL_LIVE_POOL_THREADS).
+    QThreadPool livePool;
+    QTimer stallTimer;
+    QHash<int, double> fpsOverrides;       // index -> fps from setTargetFps()
+    QSet<int> hiddenTiles;                 // survives worker restarts
+    QList<QPointer<RtspProbe>> probes;     // in flight; cancelled by stopStreaming()
+    QHash<StreamWorker*, std::shared_ptr<StreamWorker>> launched;  // process() queued, not yet retired
+    static constexpr qint64 kStallTimeoutMs = 3000;     // live -> stalled
+    static constexpr qint64 kConnectTimeoutMs = 10000;  // connecting -> first sample
 };
 
 #endif // STREAMMANAGER_H
@@ -1,133 +1,224 @@
 #include "streamworker.h"
 #include <QDebug>
-#include <QThread>
+#include <QMutexLocker>
+#include "gst_bus_dispatcher.h"
+#include "metrics_registry.h"
 
-StreamWorker::StreamWorker(const std::string& url, int index, QObject* parent)
+StreamWorker::StreamWorker(const std::string& url, int index, FrameHandoff handoff, QObject* parent)
     : QObject(parent),
       url(url),
       index(index),
+      handoff(handoff),
       pipeline(nullptr),
       appsink(nullptr),
       running(true),
       isConnected(false)
 {
     gst_init(nullptr, nullptr);
+    auto& m = MetricsRegistry::instance();
+    const QString cam = MetricsRegistry::label("camera", index);
+    mDecoded = &m.counter("camvigil_live_frames_decoded_total", "Decoded frames pulled from the live appsink", cam);
+    mDropped = &m.counter("camvigil_live_frames_dropped_total", "Decoded frames dropped by the live rate cap", cam);
+    mPull    = &m.histogram("camvigil_live_appsink_pull_seconds", "Time spent in gst_app_sink_pull_sample", cam);
 }
 
 StreamWorker::~StreamWorker() {
     stop();
-    if (appsink) {
-        gst_object_unref(appsink);
-        appsink = nullptr;
-    }
-    if (pipeline) {
-        gst_element_set_state(pipeline, GST_STATE_NULL);
-        gst_object_unref(pipeline);
-        pipeline = nullptr;
+}
+
+double StreamWorker::targetFpsFromEnv() {
+    bool ok = false;
+    const double fps = qEnvironmentVariable("CAMVIGIL_LIVE_FPS").toDouble(&ok);
+    return (ok && fps > 0.0) ? fps : 0.0;
+}
+
+void StreamWorker::setTargetFps(double fps) {
+    minIntervalUs = fps > 0.0 ? static_cast<qint64>(1000000.0 / fps) : 0;
+}
+
+qint64 StreamWorker::msSinceLastSample() const {
+    qint64 last = lastSampleUs.load();
+    if (!gate.isVisible()) last = qMax(last, gate.lastBufferUs());
+    return (g_get_monotonic_time() - last) / 1000;
+}
+
+QString StreamWorker::liveDecodeDescription(FrameHandoff handoff) {
+    if (handoff == FrameHandoff::Pixmap) {
+        return "vaapih264dec ! videoconvert ! "
+               "videoscale ! video/x-raw,format=RGB,width=640,height=480";
     }
+    // VA-API hands out NV12 surfaces (mapped, not converted); avdec_h264 produces I420.
+    return QString("%1 ! video/x-raw,format=(string){NV12,I420}").arg(liveDecoderName());
+}
+
+QString StreamWorker::liveDecoderName() {
+    GstElementFactory* vaapi = gst_element_factory_find("vaapih264dec");
+    if (!vaapi) return "avdec_h264";
+    gst_object_unref(vaapi);
+    return "vaapih264dec";
 }
 
 void StreamWorker::process() {
+    QMutexLocker lock(&lifecycleMutex);
+    if (!running || pipeline) return;   // stopped before the pool got to us
+
     QString pipelineDesc = QString(
         "rtspsrc location=\"%1\" latency=200 ! "
-        "rtph264depay ! h264parse ! vaapih264dec ! videoconvert ! "
-        "videoscale ! video/x-raw,format=RGB,width=640,height=480 ! "
+        "rtph264depay ! h264parse name=parse ! %2 ! "
         "appsink name=mysink sync=false"
-    ).arg(QString::fromStdString(url));
+    ).arg(QString::fromStdString(url), liveDecodeDescription(handoff));
 
     GError* error = nullptr;
     pipeline = gst_parse_launch(pipelineDesc.toUtf8().constData(), &error);
     if (!pipeline) {
-        qDebug() << "StreamWorker[" << index << "]: Failed to create pipeline:" << (error ? error->message : "Unknown error");
+        qWarning() << "StreamWorker[" << index << "]: Failed to create pipeline:" << (error ? error->message : "Unknown error");
+        if (error) g_error_free(error);
         emit streamError(index, url);
         return;
     }
 
     appsink = gst_bin_get_by_name(GST_BIN(pipeline), "mysink");
     if (!appsink) {
-        qDebug() << "StreamWorker[" << index << "]: Failed to get appsink.";
+        qWarning() << "StreamWorker[" << index << "]: Failed to get appsink.";
         emit streamError(index, url);
-        gst_object_unref(pipeline);
-        pipeline = nullptr;
+        teardown_();
         return;
     }
 
+    if (GstElement* parse = gst_bin_get_by_name(GST_BIN(pipeline), "parse")) {
+        GstPad* src = gst_element_get_static_pad(parse, "src");
+        gate.attach(src);
+        if (src) gst_object_unref(src);
+        gst_object_unref(parse);
+    }
+
     gst_app_sink_set_emit_signals(GST_APP_SINK(appsink), false);
     gst_app_sink_set_drop(GST_APP_SINK(appsink), true);
     gst_app_sink_set_max_buffers(GST_APP_SINK(appsink), 1);
 
+    GstAppSinkCallbacks callbacks = {};
+    callbacks.new_sample = &StreamWorker::onNewSample;
+    gst_app_sink_set_callbacks(GST_APP_SINK(appsink), &callbacks, this, nullptr);
+
+    busWatch = GstBusDispatcher::instance().watch(pipeline, [this](GstMessage* msg){
+        onBusMessage(msg);
+    });
+
+    sawSample = false;
+    lastSampleUs = g_get_monotonic_time();   // stall clock starts at connect
     GstStateChangeReturn ret = gst_element_set_state(pipeline, GST_STATE_PLAYING);
     if (ret == GST_STATE_CHANGE_FAILURE) {
-        qDebug() << "StreamWorker[" << index << "]: Failed to set pipeline to PLAYING state.";
+        qWarning() << "StreamWorker[" << index << "]: Failed to set pipeline to PLAYING state.";
         emit streamError(index, url);
-        gst_object_unref(appsink);
-        gst_object_unref(pipeline);
-        appsink = nullptr;
-        pipeline = nullptr;
+        teardown_();
         return;
     }
 
     qDebug() << "StreamWorker[" << index << "] started streaming.";
-
     isConnected = true;
-    int nullSampleCount = 0;
-    const int MAX_NULL_SAMPLES = 30;
-
-    while (running) {
-        GstSample* sample = gst_app_sink_pull_sample(GST_APP_SINK(appsink));
-        if (!sample) {
-            nullSampleCount++;
-            QThread::msleep(100);
-            if (nullSampleCount >= MAX_NULL_SAMPLES) {
-                qDebug() << "StreamWorker[" << index << "] timeout: No frames received after"
-                         << MAX_NULL_SAMPLES << "attempts.";
-                emit streamError(index, url);
-                break;
-            }
-            continue;
-        }
-
-        nullSampleCount = 0;
-        GstBuffer* buffer = gst_sample_get_buffer(sample);
-        GstCaps* caps = gst_sample_get_caps(sample);
-        if (!caps) {
-            gst_sample_unref(sample);
-            continue;
-        }
-
-        GstStructure* s = gst_caps_get_structure(caps, 0);
-        int width = 0, height = 0;
-        gst_structure_get_int(s, "width", &width);
-        gst_structure_get_int(s, "height", &height);
-
-        GstMapInfo map;
-        if (!gst_buffer_map(buffer, &map, GST_MAP_READ)) {
-            gst_sample_unref(sample);
-            continue;
-        }
-
-        QImage image((uchar*)map.data, width, height, QImage::Format_RGB888);
-        emit frameReady(index, QPixmap::fromImage(image.copy()));
-
-        gst_buffer_unmap(buffer, &map);
+}
+
+GstFlowReturn StreamWorker::onNewSample(GstAppSink* sink, gpointer user_data) {
+    auto* self = static_cast<StreamWorker*>(user_data);
+    const qint64 t0 = g_get_monotonic_time();
+    GstSample* sample = gst_app_sink_pull_sample(sink);
+    self->mPull->observeUs(g_get_monotonic_time() - t0);
+    if (!sample) return GST_FLOW_OK;
+    self->handleSample(sample);
+    return GST_FLOW_OK;
+}
+
+// Runs on the pipeline's streaming thread; keep it short.
+void StreamWorker::handleSample(GstSample* sample) {
+    const qint64 now = g_get_monotonic_time();
+    lastSampleUs = now;
+    sawSample = true;
+
+    mDecoded->inc();
+
+    // Per-camera rate gate: drop early frames here instead of sleeping.
+    const qint64 interval = minIntervalUs.load();
+    if (!running || (interval > 0 && now - lastEmitUs.load() < interval)) {
+        mDropped->inc();
         gst_sample_unref(sample);
+        return;
+    }
+    lastEmitUs = now;
 
-        QThread::msleep(200);  // Throttle for 5 fps
+    if (handoff == FrameHandoff::Sample) {
+        // Ownership of the sample moves into the LiveFrame; the GL grid maps it once.
+        emit sampleReady(index, LiveFrame(sample));
+        return;
+    }
+
+    GstBuffer* buffer = gst_sample_get_buffer(sample);
+    GstCaps* caps = gst_sample_get_caps(sample);
+    if (!caps) {
+        gst_sample_unref(sample);
+        return;
     }
 
-    // Cleanup
-    gst_element_set_state(pipeline, GST_STATE_NULL);
-    gst_object_unref(appsink);
-    gst_object_unref(pipeline);
-    appsink = nullptr;
-    pipeline = nullptr;
+    GstStructure* s = gst_caps_get_structure(caps, 0);
+    int width = 0, height = 0;
+    gst_structure_get_int(s, "width", &width);
+    gst_structure_get_int(s, "height", &height);
 
-    //emit finished();
+    GstMapInfo map;
+    if (!gst_buffer_map(buffer, &map, GST_MAP_READ)) {
+        gst_sample_unref(sample);
+        return;
+    }
+
+    QImage image((uchar*)map.data, width, height, QImage::Format_RGB888);
+    emit frameReady(index, QPixmap::fromImage(image.copy()));
+
+    gst_buffer_unmap(buffer, &map);
+    gst_sample_unref(sample);
 }
 
-void StreamWorker::stop() {
-    running = false;
+// Runs on the bus dispatcher thread. Errors and EOS mark the worker failed so the
+// manager's watchdog retires it on its next tick instead of after the timeout.
+void StreamWorker::onBusMessage(GstMessage* message) {
+    switch (GST_MESSAGE_TYPE(message)) {
+    case GST_MESSAGE_ERROR: {
+        GError* err = nullptr;
+        gchar* debug_info = nullptr;
+        gst_message_parse_error(message, &err, &debug_info);
+        qWarning() << "StreamWorker[" << index << "] GST ERROR:" << (err ? err->message : "unknown");
+        g_clear_error(&err);
+        g_free(debug_info);
+        failed = true;
+        break;
+    }
+    case GST_MESSAGE_EOS:
+        qDebug() << "StreamWorker[" << index << "] GST EOS";
+        failed = true;
+        break;
+    default:
+        break;
+    }
+}
+
+void StreamWorker::teardown_() {
+    GstBusDispatcher::instance().unwatch(busWatch);
+    busWatch = 0;
+    if (pipeline) {
+        // NULL joins the streaming threads, so no callback can outlive this.
+        gst_element_set_state(pipeline, GST_STATE_NULL);
+    }
+    if (appsink) {
+        gst_object_unref(appsink);
+        appsink = nullptr;
+    }
     if (pipeline) {
-        gst_element_send_event(pipeline, gst_event_new_eos());
+        gst_object_unref(pipeline);
+        pipeline = nullptr;
     }
+    isConnected = false;
+}
+
+void StreamWorker::stop() {
+    running = false;
+    QMutexLocker lock(&lifecycleMutex);
+    teardown_();
 }
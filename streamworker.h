@@ -4,35 +4,94 @@
 #include <QObject>
 #include <QImage>
 #include <QPixmap>
+#include <QMutex>
+#include <atomic>
 #include <string>
 #include <gst/gst.h>
 #include <gst/app/gstappsink.h>
+#include "live_frame.h"
+#include "keyframe_gate.h"
+
+class MetricCounter;
+class MetricHistogram;
+
+// How decoded frames leave the worker.
+//  Pixmap: legacy QLabel wall (QImage copy -> QPixmap per frame)
+//  Sample: ref-counted GstSample handed to the GL grid, no pixel copies
+enum class FrameHandoff { Pixmap, Sample };
 
 class StreamWorker : public QObject {
     Q_OBJECT
 public:
-    explicit StreamWorker(const std::string& url, int index, QObject* parent = nullptr);
+    explicit StreamWorker(const std::string& url, int index,
+                          FrameHandoff handoff = FrameHandoff::Sample,
+                          QObject* parent = nullptr);
     ~StreamWorker();
 
-    // Process the stream in a dedicated thread.
+    // Build the pipeline and start it; returns immediately. Frames arrive on
+    // GStreamer's streaming thread via the appsink new-sample callback.
     void process();
+    // Tear the pipeline down (blocks until streaming threads have joined).
     void stop();
 
     bool isCameraConnected() const { return isConnected; }
 
+    // Upper bound on emitted frames per second; 0 passes every decoded frame.
+    void setTargetFps(double fps);
+    // CAMVIGIL_LIVE_FPS, default 0 (camera rate).
+    static double targetFpsFromEnv();
+    // Hidden tiles decode keyframes only; full rate resumes at the next keyframe.
+    void setVisible(bool visible) { gate.setVisible(visible); }
+    // Milliseconds since the appsink last produced a sample (or since start).
+    // While hidden, compressed input counts too: keyframe-only decode is sparse.
+    qint64 msSinceLastSample() const;
+    // Bus reported ERROR/EOS; the manager retires the worker on its next tick.
+    bool hasFailed() const { return failed; }
+    // Set by the first decoded sample; until then only the connect timeout applies.
+    bool hasFirstSample() const { return sawSample; }
+
+    // Decoder tail of the live pipeline (after h264parse) for the given handoff.
+    //  Pixmap: CPU convert + scale to 640x480 RGB for QLabel
+    //  Sample: NV12/I420 straight out of the decoder; the GL grid converts and scales
+    static QString liveDecodeDescription(FrameHandoff handoff);
+    // vaapih264dec when VA-API is available, avdec_h264 otherwise.
+    static QString liveDecoderName();
+
 signals:
     // Emits a new frame as a QPixmap.
     void frameReady(int index, const QPixmap &pixmap);
+    // Emits a new frame as a shared sample (FrameHandoff::Sample).
+    void sampleReady(int index, const LiveFrame &frame);
     void streamError(int index, const std::string &url);
     void finished();
 
 private:
+    static GstFlowReturn onNewSample(GstAppSink* sink, gpointer user_data);
+    void handleSample(GstSample* sample);
+    void onBusMessage(GstMessage* message);
+    void teardown_();
+
     std::string url;
     int index;
+    FrameHandoff handoff;
     GstElement* pipeline;
     GstElement* appsink;
-    bool running;
-    bool isConnected;
+    std::atomic<bool> running;
+    std::atomic<bool> isConnected;
+    std::atomic<bool> failed{false};
+    std::atomic<bool> sawSample{false};
+
+    QMutex lifecycleMutex;                 // serialises process()/stop() across pool threads
+    std::atomic<qint64> minIntervalUs{0};
+    std::atomic<qint64> lastEmitUs{0};
+    std::atomic<qint64> lastSampleUs{0};
+    guint busWatch = 0;                    // GstBusDispatcher token
+    KeyframeGate gate;                     // on h264parse src, before the decoder
+
+    // camvigil_live_* series for this camera (registry-owned)
+    MetricCounter*   mDecoded = nullptr;
+    MetricCounter*   mDropped = nullptr;
+    MetricHistogram* mPull    = nullptr;
 };
 
 #endif // STREAMWORKER_H
@@ -7,38 +7,27 @@
 #include <QResizeEvent>
 #include <QEvent>
 #include <gst/video/videooverlay.h>
-
-// -------------------- Bus thread --------------------
-void GstBusThread::run() {
-    if (!pipeline) return;
-    GstBus *bus = gst_element_get_bus(pipeline);
-    if (!bus) return;
-
-    for (;;) {
-        GstMessage *msg = gst_bus_timed_pop(bus, GST_MSECOND * 200);
-        if (!msg) {
-            if (isInterruptionRequested()) break;
-            continue;
-        }
-        switch (GST_MESSAGE_TYPE(msg)) {
-        case GST_MESSAGE_ERROR: {
-            GError *err = nullptr; gchar *dbg = nullptr;
-            gst_message_parse_error(msg, &err, &dbg);
-            emit gstError(QString("GStreamer error: %1 (%2)")
-                          .arg(err ? err->message : "unknown")
-                          .arg(dbg ? dbg : ""));
-            g_clear_error(&err); g_free(dbg);
-            break;
-        }
-        case GST_MESSAGE_EOS:
-            emit gstEos();
-            break;
-        default: break;
-        }
-        gst_message_unref(msg);
-        if (isInterruptionRequested()) break;
+#include "gst_bus_dispatcher.h"
+
+// -------------------- Bus messages --------------------
+// Runs on the GstBusDispatcher thread; hop to the GUI thread before touching widgets.
+void VideoPlayerWindow::onBusMessage(GstMessage *msg) {
+    switch (GST_MESSAGE_TYPE(msg)) {
+    case GST_MESSAGE_ERROR: {
+        GError *err = nullptr; gchar *dbg = nullptr;
+        gst_message_parse_error(msg, &err, &dbg);
+        const QString text = QString("GStreamer error: %1 (%2)")
+                                 .arg(err ? err->message : "unknown")
+                                 .arg(dbg ? dbg : "");
+        g_clear_error(&err); g_free(dbg);
+        QMetaObject::invokeMethod(this, [this, text]{ onGstError(text); }, Qt::QueuedConnection);
+        break;
+    }
+    case GST_MESSAGE_EOS:
+        QMetaObject::invokeMethod(this, [this]{ onGstEos(); }, Qt::QueuedConnection);
+        break;
+    default: break;
     }
-    gst_object_unref(bus);
 }
 
 // -------------------- helpers --------------------
@@ -160,12 +149,10 @@ VideoPlayerWindow::VideoPlayerWindow(const QString& filePath, QWidget *parent)
     // Build and start pipeline
     initPipeline(filePath);
 
-    // Bus thread
-    busThread = new GstBusThread(this);
-    busThread->setPipeline(pipeline);
-    connect(busThread, &GstBusThread::gstError, this, &VideoPlayerWindow::onGstError);
-    connect(busThread, &GstBusThread::gstEos,   this, &VideoPlayerWindow::onGstEos);
-    busThread->start();
+    // Bus watch on the shared dispatcher thread
+    busWatch = GstBusDispatcher::instance().watch(pipeline, [this](GstMessage *msg){
+        onBusMessage(msg);
+    });
 }
 
 void VideoPlayerWindow::initPipeline(const QString &filePath) {
@@ -402,10 +389,8 @@ void VideoPlayerWindow::keyPressEvent(QKeyEvent *e) {
 
 VideoPlayerWindow::~VideoPlayerWindow() {
     if (updateTimer) updateTimer->stop();
-    if (busThread) {
-        busThread->requestInterruption();
-        busThread->wait(300);
-    }
+    GstBusDispatcher::instance().unwatch(busWatch);
+    busWatch = 0;
     cleanupPipeline();
 }
 
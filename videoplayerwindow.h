@@ -7,7 +7,6 @@
 #include <QPushButton>
 #include <QHBoxLayout>
 #include <QTimer>
-#include <QThread>
 #include <QResizeEvent>
 #include <QEvent>
 #include <QKeyEvent>
@@ -16,19 +15,6 @@
 #include <gst/gst.h>
 #include <gst/video/videooverlay.h>
 
-class GstBusThread : public QThread {
-    Q_OBJECT
-public:
-    explicit GstBusThread(QObject *parent=nullptr) : QThread(parent) {}
-    void setPipeline(GstElement *p) { pipeline = p; }
-    void run() override;
-signals:
-    void gstError(QString msg);
-    void gstEos();
-private:
-    GstElement *pipeline = nullptr;
-};
-
 class VideoPlayerWindow : public QWidget {
     Q_OBJECT
 public:
@@ -54,6 +40,7 @@ private:
     // pipeline/setup
     void initPipeline(const QString &filePath);
     void installBusSyncHandler();
+    void onBusMessage(GstMessage *msg);
     static GstBusSyncReply onBusSync(GstBus *bus, GstMessage *msg, gpointer user_data);
     void bindOverlay();
     void cleanupPipeline();
@@ -71,7 +58,7 @@ private:
     // GStreamer
     GstElement *pipeline = nullptr;
     GstElement *videoSink = nullptr;
-    GstBusThread *busThread = nullptr;
+    guint       busWatch = 0;       // GstBusDispatcher token
 
     // UI
     QWidget      *videoArea = nullptr;